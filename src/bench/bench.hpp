@@ -0,0 +1,132 @@
+#ifndef __BENCH__
+#define __BENCH__
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../types/types.hpp"
+
+namespace bench
+{
+  struct options
+  {
+    std::string filter{};
+    std::string output_path{};
+    types::whole_num num_samples{15};
+    double warmup_secs{0.1};
+    double min_sample_secs{0.005};
+  };
+
+  struct result
+  {
+    std::string name{};
+    types::long_whole_num size{};
+    types::long_whole_num num_samples{};
+    types::long_whole_num num_iterations{};
+    double median_ns{};
+    double mad_ns{};
+    double min_ns{};
+  };
+
+  // Keeps the compiler from discarding the computation of a value that is otherwise unused.
+  template <typename T>
+  inline void
+  do_not_optimize(const T &value)
+  {
+    asm volatile("" : : "r"(&value) : "memory");
+  }
+
+  // Every benchmark is timed as below.
+  //   1. The function is run repeatedly for the warmup duration, to settle caches, branch predictors and the CPU frequency.
+  //   2. The no. of iterations per sample is doubled until a sample takes at least the minimum sample duration.
+  //   3. The samples are timed, and summarised by the median and the median absolute deviation of the time per iteration.
+  // The median and the MAD are robust to the outliers caused by preemption and interrupts, unlike the mean and the standard deviation.
+  class runner
+  {
+    private:
+      bench::options opts{};
+      std::vector<bench::result> results{};
+
+      bool
+      is_selected(const std::string &name) const;
+
+      void
+      add_result(
+        const std::string &name,
+        types::long_whole_num size,
+        types::long_whole_num num_iterations,
+        std::vector<double> &sample_ns
+      );
+
+    public:
+      runner(types::num argc, char **argv);
+
+      template <typename function_type>
+      void
+      run(const std::string &name, types::long_whole_num size, const function_type &function);
+
+      void
+      report() const;
+  };
+}
+
+template <typename function_type>
+void
+bench::runner::run(const std::string &name, types::long_whole_num size, const function_type &function)
+{
+  using clock = std::chrono::steady_clock;
+
+  if (!this->is_selected(name))
+  {
+    return;
+  }
+
+  auto get_secs{[](clock::time_point start) {
+    return std::chrono::duration<double>(clock::now() - start).count();
+  }};
+
+  clock::time_point warmup_start{clock::now()};
+
+  do
+  {
+    function();
+  } while (get_secs(warmup_start) < this->opts.warmup_secs);
+
+  types::long_whole_num num_iterations{1};
+
+  while (true)
+  {
+    clock::time_point start{clock::now()};
+
+    for (types::long_whole_num i{}; i < num_iterations; i++)
+    {
+      function();
+    }
+
+    if (get_secs(start) >= this->opts.min_sample_secs || num_iterations >= (1UL << 40))
+    {
+      break;
+    }
+
+    num_iterations *= 2;
+  }
+
+  std::vector<double> sample_ns{};
+
+  for (types::whole_num i{}; i < this->opts.num_samples; i++)
+  {
+    clock::time_point start{clock::now()};
+
+    for (types::long_whole_num j{}; j < num_iterations; j++)
+    {
+      function();
+    }
+
+    sample_ns.push_back(get_secs(start) * 1e9 / num_iterations);
+  }
+
+  this->add_result(name, size, num_iterations, sample_ns);
+}
+
+#endif
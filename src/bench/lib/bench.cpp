@@ -0,0 +1,152 @@
+#include "../bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+static double
+get_median(std::vector<double> values)
+{
+  std::sort(values.begin(), values.end());
+  types::whole_num mid{static_cast<types::whole_num>(values.size() / 2)};
+
+  return values.size() % 2 ? values.at(mid) : (values.at(mid - 1) + values.at(mid)) / 2;
+}
+
+static void
+print_usage()
+{
+  std::cerr << "Usage: bench-micro [--filter <substring>] [--samples <n>] [--warmup <secs>] [--output <path>]\n";
+}
+
+bench::runner::runner(types::num argc, char **argv)
+{
+  for (types::num i{1}; i < argc; i += 2)
+  {
+    std::string name{argv[i]};
+
+    if (i + 1 >= argc)
+    {
+      print_usage();
+      throw std::invalid_argument{"Missing value for " + name};
+    }
+
+    std::string value{argv[i + 1]};
+
+    if (name == "--filter")
+    {
+      this->opts.filter = value;
+    }
+    else if (name == "--samples")
+    {
+      this->opts.num_samples = std::max(std::stoul(value), 1UL);
+    }
+    else if (name == "--warmup")
+    {
+      this->opts.warmup_secs = std::stod(value);
+    }
+    else if (name == "--output")
+    {
+      this->opts.output_path = value;
+    }
+    else
+    {
+      print_usage();
+      throw std::invalid_argument{"Unknown flag: " + name};
+    }
+  }
+}
+
+bool
+bench::runner::is_selected(const std::string &name) const
+{
+  return name.find(this->opts.filter) != std::string::npos;
+}
+
+void
+bench::runner::add_result(
+  const std::string &name,
+  types::long_whole_num size,
+  types::long_whole_num num_iterations,
+  std::vector<double> &sample_ns
+)
+{
+  bench::result current_result{};
+  current_result.name = name;
+  current_result.size = size;
+  current_result.num_samples = sample_ns.size();
+  current_result.num_iterations = num_iterations;
+  current_result.median_ns = get_median(sample_ns);
+  current_result.min_ns = *std::min_element(sample_ns.begin(), sample_ns.end());
+
+  std::vector<double> deviations{};
+
+  for (const auto &ns : sample_ns)
+  {
+    deviations.push_back(std::abs(ns - current_result.median_ns));
+  }
+
+  current_result.mad_ns = get_median(deviations);
+
+  std::fprintf(
+    stderr,
+    "%-44s n=%-4lu %14.1f ns  +/- %10.1f ns  (min %.1f ns, %lu x %lu)\n",
+    name.c_str(),
+    size,
+    current_result.median_ns,
+    current_result.mad_ns,
+    current_result.min_ns,
+    current_result.num_samples,
+    num_iterations
+  );
+
+  this->results.push_back(current_result);
+}
+
+// Results are written as JSON, one benchmark per line, so that the outputs of two revisions can be diffed directly.
+void
+bench::runner::report() const
+{
+  std::ofstream out_file{};
+
+  if (!this->opts.output_path.empty())
+  {
+    out_file.open(this->opts.output_path);
+
+    if (!out_file)
+    {
+      throw std::runtime_error{"Cannot open " + this->opts.output_path};
+    }
+  }
+
+  std::ostream &out_stream{this->opts.output_path.empty() ? std::cout : out_file};
+  char buffer[512];
+
+  out_stream << "{\"results\": [\n";
+
+  for (types::whole_num i{}; i < this->results.size(); i++)
+  {
+    const bench::result &current_result{this->results.at(i)};
+
+    std::snprintf(
+      buffer,
+      sizeof(buffer),
+      "  {\"name\": \"%s\", \"size\": %lu, \"samples\": %lu, \"iterations\": %lu, \"median_ns\": %.1f, \"mad_ns\": %.1f, \"min_ns\": %.1f}%s\n",
+      current_result.name.c_str(),
+      current_result.size,
+      current_result.num_samples,
+      current_result.num_iterations,
+      current_result.median_ns,
+      current_result.mad_ns,
+      current_result.min_ns,
+      i + 1 < this->results.size() ? "," : ""
+    );
+
+    out_stream << buffer;
+  }
+
+  out_stream << "]}\n";
+}
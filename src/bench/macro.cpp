@@ -0,0 +1,535 @@
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../types/types.hpp"
+
+// End-to-end benchmarks, replaying the command-line form of every menu action as a separate process.
+// Each scenario is run a few times, and the run with the median wall time is reported.
+// Wall time covers the whole process, including start-up and output, while CPU time and peak RSS come from `wait4`.
+
+struct options
+{
+  std::string binary_path{"./main-bench"};
+  std::string scenarios_path{"src/bench/scenarios.txt"};
+  std::string output_path{};
+  std::string baseline_path{};
+  std::string filter{};
+  types::whole_num num_repeats{3};
+  types::whole_num timeout_secs{120};
+  double threshold{0.1};
+};
+
+struct scenario
+{
+  std::string name{};
+  types::short_whole_num size{};
+  std::vector<std::string> args{};
+};
+
+struct measurement
+{
+  double wall_secs{};
+  double cpu_secs{};
+  types::long_whole_num peak_rss_kb{};
+  types::long_whole_num num_rows{};
+  types::num exit_status{};
+  bool is_timed_out{};
+};
+
+static void
+print_usage()
+{
+  std::cerr << "Usage: bench-macro [--binary <path>] [--scenarios <path>] [--filter <substring>] [--repeat <n>]\n";
+  std::cerr << "                   [--timeout <secs>] [--output <path>] [--baseline <path>] [--threshold <fraction>]\n";
+}
+
+static options
+parse_options(types::num argc, char **argv)
+{
+  options opts{};
+
+  for (types::num i{1}; i < argc; i += 2)
+  {
+    std::string name{argv[i]};
+
+    if (i + 1 >= argc)
+    {
+      print_usage();
+      throw std::invalid_argument{"Missing value for " + name};
+    }
+
+    std::string value{argv[i + 1]};
+
+    if (name == "--binary")
+    {
+      opts.binary_path = value;
+    }
+    else if (name == "--scenarios")
+    {
+      opts.scenarios_path = value;
+    }
+    else if (name == "--output")
+    {
+      opts.output_path = value;
+    }
+    else if (name == "--baseline")
+    {
+      opts.baseline_path = value;
+    }
+    else if (name == "--filter")
+    {
+      opts.filter = value;
+    }
+    else if (name == "--repeat")
+    {
+      opts.num_repeats = std::max(std::stoul(value), 1UL);
+    }
+    else if (name == "--timeout")
+    {
+      opts.timeout_secs = std::stoul(value);
+    }
+    else if (name == "--threshold")
+    {
+      opts.threshold = std::stod(value);
+    }
+    else
+    {
+      print_usage();
+      throw std::invalid_argument{"Unknown flag: " + name};
+    }
+  }
+
+  return opts;
+}
+
+// Sizes are given as a comma separated list of sizes and inclusive ranges, like 3-6,8,10.
+static std::vector<types::short_whole_num>
+parse_sizes(const std::string &str)
+{
+  std::vector<types::short_whole_num> sizes{};
+  std::istringstream in_stream{str};
+  std::string current_range{};
+
+  while (std::getline(in_stream, current_range, ','))
+  {
+    std::size_t dash_pos{current_range.find('-')};
+    types::short_whole_num min_size{static_cast<types::short_whole_num>(std::stoul(current_range.substr(0, dash_pos)))};
+    types::short_whole_num max_size{min_size};
+
+    if (dash_pos != std::string::npos)
+    {
+      max_size = static_cast<types::short_whole_num>(std::stoul(current_range.substr(dash_pos + 1)));
+    }
+
+    for (types::short_whole_num n{min_size}; n <= max_size; n++)
+    {
+      sizes.push_back(n);
+    }
+  }
+
+  return sizes;
+}
+
+// The placeholders below are expanded in every argument.
+//   {size}    - The size.
+//   {linear}  - Rules 90 and 150 alternating, a reversible linear ECA under null boundary for many sizes.
+//   {uniform} - Rule 51 for every cell, a reversible ECA under both boundaries for every size.
+static std::string
+expand_arg(std::string arg, types::short_whole_num size)
+{
+  std::string linear_rules{};
+  std::string uniform_rules{};
+
+  for (types::short_whole_num i{}; i < size; i++)
+  {
+    linear_rules += (i == 0 ? "" : ",") + std::string{i % 2 ? "150" : "90"};
+    uniform_rules += (i == 0 ? "" : ",") + std::string{"51"};
+  }
+
+  std::map<std::string, std::string> placeholders{
+    {"{size}", std::to_string(size)},
+    {"{linear}", linear_rules},
+    {"{uniform}", uniform_rules}
+  };
+
+  for (const auto &placeholder : placeholders)
+  {
+    std::size_t pos{};
+
+    while ((pos = arg.find(placeholder.first)) != std::string::npos)
+    {
+      arg.replace(pos, placeholder.first.size(), placeholder.second);
+    }
+  }
+
+  return arg;
+}
+
+// Every non-empty line, other than comments, is a scenario of the form `<name> <sizes> <command> [--<flag> <value>]...`.
+static std::vector<scenario>
+read_scenarios(const options &opts)
+{
+  std::ifstream in_file{opts.scenarios_path};
+
+  if (!in_file)
+  {
+    throw std::runtime_error{"Cannot open " + opts.scenarios_path};
+  }
+
+  std::vector<scenario> scenarios{};
+  std::string line{};
+
+  while (std::getline(in_file, line))
+  {
+    std::istringstream in_stream{line};
+    std::string name{};
+    std::string sizes{};
+    std::vector<std::string> args{};
+    std::string current_arg{};
+
+    if (!(in_stream >> name) || name.at(0) == '#')
+    {
+      continue;
+    }
+
+    if (!(in_stream >> sizes))
+    {
+      throw std::runtime_error{"Missing sizes for scenario " + name};
+    }
+
+    while (in_stream >> current_arg)
+    {
+      args.push_back(current_arg);
+    }
+
+    if (name.find(opts.filter) == std::string::npos)
+    {
+      continue;
+    }
+
+    // Rows are counted from the output, which is unambiguous in CSV.
+    if (std::find(args.begin(), args.end(), "--format") == args.end())
+    {
+      args.push_back("--format");
+      args.push_back("csv");
+    }
+
+    for (const auto &size : parse_sizes(sizes))
+    {
+      scenarios.push_back({name, size, {}});
+
+      for (const auto &arg : args)
+      {
+        scenarios.back().args.push_back(expand_arg(arg, size));
+      }
+    }
+  }
+
+  return scenarios;
+}
+
+// Rows are the lines of results, ignoring blank lines and the borders of tables.
+// Messages are records too, so every line of a multi-line message counts.
+static types::long_whole_num
+count_rows(const char *data, std::size_t size, bool &is_line_start, bool &is_skipped_line)
+{
+  types::long_whole_num num_rows{};
+
+  for (std::size_t i{}; i < size; i++)
+  {
+    if (is_line_start)
+    {
+      is_skipped_line = data[i] == '\n' || data[i] == '+';
+      is_line_start = false;
+    }
+
+    if (data[i] == '\n')
+    {
+      num_rows += !is_skipped_line;
+      is_line_start = true;
+    }
+  }
+
+  return num_rows;
+}
+
+static measurement
+run_scenario(const options &opts, const scenario &current_scenario)
+{
+  using clock = std::chrono::steady_clock;
+
+  int pipe_fds[2];
+
+  if (pipe(pipe_fds) != 0)
+  {
+    throw std::runtime_error{"Cannot create pipe"};
+  }
+
+  std::vector<char *> argv{const_cast<char *>(opts.binary_path.c_str())};
+
+  for (const auto &arg : current_scenario.args)
+  {
+    argv.push_back(const_cast<char *>(arg.c_str()));
+  }
+
+  argv.push_back(nullptr);
+
+  clock::time_point start{clock::now()};
+  pid_t pid{fork()};
+
+  if (pid < 0)
+  {
+    throw std::runtime_error{"Cannot fork"};
+  }
+
+  if (pid == 0)
+  {
+    int null_fd{open("/dev/null", O_WRONLY)};
+
+    // Messages and errors go to stderr, which is discarded, as only the exit status of a failed run is reported.
+    dup2(pipe_fds[1], STDOUT_FILENO);
+    dup2(null_fd, STDERR_FILENO);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(null_fd);
+    execv(argv.at(0), argv.data());
+    _exit(127);
+  }
+
+  close(pipe_fds[1]);
+
+  measurement result{};
+  char buffer[1 << 16];
+  bool is_line_start{true};
+  bool is_skipped_line{};
+  pollfd poll_fd{pipe_fds[0], POLLIN, 0};
+
+  while (true)
+  {
+    types::num timeout_ms{static_cast<types::num>(
+      opts.timeout_secs * 1000 - std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start).count()
+    )};
+
+    if (timeout_ms <= 0 || poll(&poll_fd, 1, timeout_ms) == 0)
+    {
+      kill(pid, SIGKILL);
+      result.is_timed_out = true;
+      break;
+    }
+
+    ssize_t num_bytes{read(pipe_fds[0], buffer, sizeof(buffer))};
+
+    if (num_bytes <= 0)
+    {
+      break;
+    }
+
+    result.num_rows += count_rows(buffer, num_bytes, is_line_start, is_skipped_line);
+  }
+
+  close(pipe_fds[0]);
+
+  int status{};
+  rusage usage{};
+  wait4(pid, &status, 0, &usage);
+
+  result.wall_secs = std::chrono::duration<double>(clock::now() - start).count();
+  result.cpu_secs = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+  result.peak_rss_kb = usage.ru_maxrss;
+  result.exit_status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+
+  return result;
+}
+
+static std::string
+get_result_name(const scenario &current_scenario)
+{
+  return current_scenario.name + "/" + std::to_string(current_scenario.size);
+}
+
+// Reads the wall time of every scenario from a file written by `--output`.
+// The file is read line by line, relying on every result being written on a line of its own.
+static std::map<std::string, double>
+read_baseline(const std::string &path)
+{
+  std::ifstream in_file{path};
+
+  if (!in_file)
+  {
+    throw std::runtime_error{"Cannot open " + path};
+  }
+
+  std::map<std::string, double> wall_secs{};
+  std::string line{};
+
+  while (std::getline(in_file, line))
+  {
+    std::size_t name_pos{line.find("\"name\": \"")};
+    std::size_t wall_pos{line.find("\"wall_secs\": ")};
+
+    if (name_pos == std::string::npos || wall_pos == std::string::npos)
+    {
+      continue;
+    }
+
+    name_pos += 9;
+    std::string name{line.substr(name_pos, line.find('"', name_pos) - name_pos)};
+    wall_secs[name] = std::stod(line.substr(wall_pos + 13));
+  }
+
+  return wall_secs;
+}
+
+static void
+write_results(const options &opts, const std::vector<std::pair<scenario, measurement>> &results)
+{
+  std::ofstream out_file{};
+
+  if (!opts.output_path.empty())
+  {
+    out_file.open(opts.output_path);
+
+    if (!out_file)
+    {
+      throw std::runtime_error{"Cannot open " + opts.output_path};
+    }
+  }
+
+  std::ostream &out_stream{opts.output_path.empty() ? std::cout : out_file};
+  char buffer[512];
+
+  out_stream << "{\"results\": [\n";
+
+  for (types::whole_num i{}; i < results.size(); i++)
+  {
+    const measurement &current_result{results.at(i).second};
+
+    std::snprintf(
+      buffer,
+      sizeof(buffer),
+      "  {\"name\": \"%s\", \"wall_secs\": %.4f, \"cpu_secs\": %.4f, \"peak_rss_kb\": %lu, \"rows\": %lu, \"rows_per_sec\": %.1f, \"status\": \"%s\"}%s\n",
+      get_result_name(results.at(i).first).c_str(),
+      current_result.wall_secs,
+      current_result.cpu_secs,
+      current_result.peak_rss_kb,
+      current_result.num_rows,
+      current_result.num_rows / std::max(current_result.wall_secs, 1e-9),
+      current_result.is_timed_out ? "timeout" : current_result.exit_status == 0 ? "ok" : "failed",
+      i + 1 < results.size() ? "," : ""
+    );
+
+    out_stream << buffer;
+  }
+
+  out_stream << "]}\n";
+}
+
+// Returns the no. of scenarios that are slower than the baseline by more than the threshold.
+static types::whole_num
+compare_results(const options &opts, const std::vector<std::pair<scenario, measurement>> &results)
+{
+  std::map<std::string, double> baseline{read_baseline(opts.baseline_path)};
+  types::whole_num num_regressions{};
+
+  std::fprintf(stderr, "\n%-32s %12s %12s %9s\n", "Scenario", "Baseline (s)", "Current (s)", "Change");
+
+  for (const auto &result : results)
+  {
+    std::string name{get_result_name(result.first)};
+    auto baseline_result{baseline.find(name)};
+
+    if (baseline_result == baseline.end())
+    {
+      std::fprintf(stderr, "%-32s %12s %12.4f %9s\n", name.c_str(), "-", result.second.wall_secs, "new");
+      continue;
+    }
+
+    double change{result.second.wall_secs / std::max(baseline_result->second, 1e-9) - 1};
+    bool is_regression{change > opts.threshold};
+    num_regressions += is_regression;
+
+    std::fprintf(
+      stderr,
+      "%-32s %12.4f %12.4f %+8.1f%%%s\n",
+      name.c_str(),
+      baseline_result->second,
+      result.second.wall_secs,
+      change * 100,
+      is_regression ? "  REGRESSION" : ""
+    );
+  }
+
+  return num_regressions;
+}
+
+int
+main(int argc, char **argv)
+{
+  try
+  {
+    options opts{parse_options(argc, argv)};
+    std::vector<std::pair<scenario, measurement>> results{};
+
+    for (const auto &current_scenario : read_scenarios(opts))
+    {
+      std::vector<measurement> runs{};
+
+      for (types::whole_num i{}; i < opts.num_repeats; i++)
+      {
+        runs.push_back(run_scenario(opts, current_scenario));
+
+        if (runs.back().is_timed_out)
+        {
+          break;
+        }
+      }
+
+      std::sort(runs.begin(), runs.end(), [](const measurement &obj_1, const measurement &obj_2) {
+        return obj_1.wall_secs < obj_2.wall_secs;
+      });
+
+      const measurement &median_run{runs.at(runs.size() / 2)};
+      results.push_back({current_scenario, median_run});
+
+      std::fprintf(
+        stderr,
+        "%-32s %10.4f s wall %10.4f s cpu %8lu KB %10lu rows%s\n",
+        get_result_name(current_scenario).c_str(),
+        median_run.wall_secs,
+        median_run.cpu_secs,
+        median_run.peak_rss_kb,
+        median_run.num_rows,
+        median_run.is_timed_out ? "  (timed out)" : median_run.exit_status == 0 ? "" : "  (failed)"
+      );
+    }
+
+    write_results(opts, results);
+
+    if (!opts.baseline_path.empty() && compare_results(opts, results) > 0)
+    {
+      return 1;
+    }
+  }
+  catch (const std::exception &err)
+  {
+    std::cerr << "ERR: " << err.what() << "\n";
+    return 2;
+  }
+
+  return 0;
+}
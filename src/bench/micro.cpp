@@ -0,0 +1,266 @@
+#include <exception>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../models/binary-1d-ca/binary-1d-ca.hpp"
+#include "../models/ca-kernels/ca-kernels.hpp"
+#include "../models/rule-vector/rule-vector.hpp"
+#include "../models/stepper/stepper.hpp"
+#include "../utils/utils.hpp"
+#include "bench.hpp"
+
+// Microbenchmarks of the core kernels, swept over the supported CA sizes.
+// The private kernels are reached through the public method that is dominated by them.
+//   - Construction fills the transition graph and the state-neighborhood maps, with the kernels of the shape of the CA.
+//     Additive CAs take the Gray code path instead, so construction is also timed on a non-additive CA, under `_non_linear`.
+//   - Reversed pseudo isomorphisms extract the rules of every candidate graph with `extract_rules`.
+
+static const types::short_whole_num min_size{3};
+
+// Alternating rules 90 and 150 form a linear CA, so that the characteristic matrix is defined for every size.
+static types::rules
+get_linear_rules(types::short_whole_num num_cells)
+{
+  types::rules rules{};
+
+  for (types::short_whole_num i{}; i < num_cells; i++)
+  {
+    rules.push_back(i % 2 ? 150 : 90);
+  }
+
+  return rules;
+}
+
+// Alternating rules 30 and 110 aren't additive, so that the CA is built and stepped by the generic kernels.
+static types::rules
+get_non_linear_rules(types::short_whole_num num_cells)
+{
+  types::rules rules{};
+
+  for (types::short_whole_num i{}; i < num_cells; i++)
+  {
+    rules.push_back(i % 2 ? 110 : 30);
+  }
+
+  return rules;
+}
+
+static const std::pair<const char *, types::rules (*)(types::short_whole_num)> rule_sets[]{
+  {"", get_linear_rules},
+  {"_non_linear", get_non_linear_rules}
+};
+
+// The steppers run on lattices far larger than a `binary_1d_ca`, to compare their throughput.
+static const types::long_whole_num stepper_sizes[]{1024, 65536};
+
+static const std::pair<const char *, models::stepper_kernel> stepper_kernels[]{
+  {"scalar", models::stepper_kernel::scalar},
+  {"bitsliced", models::stepper_kernel::bitsliced},
+  {"lookup_8", models::stepper_kernel::lookup_8},
+  {"lookup_16", models::stepper_kernel::lookup_16},
+  {"compiled", models::stepper_kernel::compiled}
+};
+
+// Rules 30, 90, 110 and 150 in turn, whose period divides the window sizes, so all the windows of a lookup stepper share a table.
+static types::rules
+get_hybrid_rules()
+{
+  return {30, 90, 110, 150};
+}
+
+static types::short_whole_num
+get_num_non_trivial_cycles(const types::transition_graph &graph)
+{
+  types::short_whole_num num_cycles{};
+
+  for (const auto &cycle : utils::transition_graph::get_cycles(graph))
+  {
+    num_cycles += cycle.size() > 2;
+  }
+
+  return num_cycles;
+}
+
+static void
+run_benchmarks(bench::runner &runner)
+{
+  for (const auto &rule_set : rule_sets)
+  {
+    for (types::short_whole_num n{min_size}; n <= models::binary_1d_ca::max_size; n++)
+    {
+      types::rules rules{rule_set.second(n)};
+
+      runner.run(std::string{"binary_1d_ca/construct"} + rule_set.first, n, [&]() {
+        models::binary_1d_ca ca{n, 1, 1, types::boundary::periodic, rules};
+        bench::do_not_optimize(ca);
+      });
+    }
+
+    for (types::short_whole_num n{min_size}; n <= models::binary_1d_ca::max_size; n++)
+    {
+      models::binary_1d_ca ca{n, 1, 1, types::boundary::periodic, rule_set.second(n)};
+
+      runner.run(std::string{"binary_1d_ca/update_config"} + rule_set.first, n, [&]() {
+        ca.update_config();
+        bench::do_not_optimize(ca);
+      });
+    }
+  }
+
+  // The kernels are timed directly on the non-additive rules, and every configuration is stepped, as one step takes nanoseconds.
+  const models::ca_kernels &kernels{models::ca_kernels::get(1, 1, types::boundary::periodic)};
+
+  for (types::short_whole_num n{min_size}; n <= models::binary_1d_ca::max_size; n++)
+  {
+    types::rules rules{get_non_linear_rules(n)};
+
+    runner.run("ca_kernels/get_next_config", n, [&]() {
+      types::short_whole_num next_configs{};
+
+      for (types::whole_num config{}; config < (1U << n); config++)
+      {
+        next_configs ^= kernels.get_next_config(static_cast<types::short_whole_num>(config), n, rules);
+      }
+
+      bench::do_not_optimize(next_configs);
+    });
+  }
+
+  for (types::short_whole_num n{min_size}; n <= models::binary_1d_ca::max_size; n++)
+  {
+    types::rules rules{get_non_linear_rules(n)};
+    types::transition_graph graph{};
+
+    runner.run("ca_kernels/fill_transition_graph", n, [&]() {
+      kernels.fill_transition_graph(n, rules, graph);
+      bench::do_not_optimize(graph);
+    });
+  }
+
+  for (types::short_whole_num n{min_size}; n <= models::binary_1d_ca::max_size; n++)
+  {
+    types::rules rules{get_non_linear_rules(n)};
+    types::transition_graph graph{};
+    types::rules extracted_rules(n, 0);
+    kernels.fill_transition_graph(n, rules, graph);
+
+    runner.run("ca_kernels/extract_rules", n, [&]() {
+      bool is_valid_ca{kernels.extract_rules(n, graph, extracted_rules)};
+      bench::do_not_optimize(is_valid_ca);
+      bench::do_not_optimize(extracted_rules);
+    });
+  }
+
+  for (const auto &kernel : stepper_kernels)
+  {
+    for (const auto &n : stepper_sizes)
+    {
+      models::stepper uniform_stepper{n, 1, 1, types::boundary::periodic, {30}, kernel.second};
+      models::stepper hybrid_stepper{n, 1, 1, types::boundary::periodic, get_hybrid_rules(), kernel.second};
+      std::vector<types::long_whole_num> config{models::stepper::pack(std::string(n / 2, '0') + "1" + std::string(n - n / 2 - 1, '0'))};
+      std::vector<types::long_whole_num> next_config{};
+
+      runner.run(std::string{"stepper/"} + kernel.first, n, [&]() {
+        uniform_stepper.step(config, next_config);
+        config.swap(next_config);
+        bench::do_not_optimize(config);
+      });
+
+      runner.run(std::string{"stepper/"} + kernel.first + "_hybrid", n, [&]() {
+        hybrid_stepper.step(config, next_config);
+        config.swap(next_config);
+        bench::do_not_optimize(config);
+      });
+    }
+  }
+
+  for (types::short_whole_num n{min_size}; n <= models::binary_1d_ca::max_size; n++)
+  {
+    models::binary_1d_ca ca{n, 1, 1, types::boundary::null, get_linear_rules(n)};
+
+    runner.run("transition_graph/get_cycles", n, [&]() {
+      types::cycles cycles{utils::transition_graph::get_cycles(ca.get_graph())};
+      bench::do_not_optimize(cycles);
+    });
+  }
+
+  for (types::short_whole_num n{min_size}; n <= models::binary_1d_ca::max_size; n++)
+  {
+    models::binary_1d_ca ca{n, 1, 1, types::boundary::null, get_linear_rules(n)};
+
+    runner.run("transition_graph/get_cycle_type", n, [&]() {
+      std::vector<types::short_whole_num> cycle_type{utils::transition_graph::get_cycle_type(ca.get_graph())};
+      bench::do_not_optimize(cycle_type);
+    });
+  }
+
+  for (types::short_whole_num n{min_size}; n <= models::binary_1d_ca::max_size; n++)
+  {
+    models::binary_1d_ca ca{n, 1, 1, types::boundary::null, get_linear_rules(n)};
+    types::short_whole_num complemented_cells{static_cast<types::short_whole_num>((1U << n) - 1)};
+
+    runner.run("binary_1d_ca/get_complemented_graph", n, [&]() {
+      types::transition_graph graph{ca.get_complemented_graph(complemented_cells)};
+      bench::do_not_optimize(graph);
+    });
+  }
+
+  // The search is exponential in the no. of non-trivial cycles, so sizes with too many of them are skipped.
+  for (types::short_whole_num n{min_size}; n <= models::binary_1d_ca::max_size; n++)
+  {
+    models::binary_1d_ca ca{n, 1, 1, types::boundary::null, get_linear_rules(n)};
+
+    if (get_num_non_trivial_cycles(ca.get_graph()) > 12)
+    {
+      continue;
+    }
+
+    runner.run("binary_1d_ca/reversed_pseudo_isomorphisms", n, [&]() {
+      bool has_trivial_partition{};
+      bool has_non_trivial_partitions{};
+      bool has_isomorphisms{ca.has_non_trivial_reversed_pseudo_isomorphisms(has_trivial_partition, has_non_trivial_partitions)};
+      bench::do_not_optimize(has_isomorphisms);
+    });
+  }
+
+  // The exhaustive search visits (2^n)! permutations, so only the smallest size is feasible.
+  for (types::short_whole_num n{min_size}; n <= 3; n++)
+  {
+    models::binary_1d_ca ca{n, 1, 1, types::boundary::null, get_linear_rules(n)};
+
+    runner.run("binary_1d_ca/is_isomorphic", n, [&]() {
+      bool is_isomorphic{ca.is_isomorphic(ca)};
+      bench::do_not_optimize(is_isomorphic);
+    });
+  }
+
+  for (types::short_whole_num n{min_size}; n <= models::binary_1d_ca::max_size; n++)
+  {
+    types::matrix matrix{models::rule_vector{get_linear_rules(n)}.get_characteristic_matrix(types::boundary::periodic)};
+
+    runner.run("matrix/get_characteristic_polynomial", n, [&]() {
+      types::polynomial coeffs{utils::matrix::get_characteristic_polynomial(matrix)};
+      bench::do_not_optimize(coeffs);
+    });
+  }
+}
+
+int
+main(int argc, char **argv)
+{
+  try
+  {
+    bench::runner runner{argc, argv};
+    run_benchmarks(runner);
+    runner.report();
+  }
+  catch (const std::exception &err)
+  {
+    std::cerr << "ERR: " << err.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,841 @@
+#include "cli.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "../instrument/instrument.hpp"
+#include "../models/binary-1d-ca-manager/binary-1d-ca-manager.hpp"
+#include "../models/binary-1d-ca/binary-1d-ca.hpp"
+#include "../models/graph-cache/graph-cache.hpp"
+#include "../models/hashlife-1d/hashlife-1d.hpp"
+#include "../models/jit-stepper/jit-stepper.hpp"
+#include "../models/necklace-graph/necklace-graph.hpp"
+#include "../models/result-cache/result-cache.hpp"
+#include "../models/rule-program/rule-program.hpp"
+#include "../models/rule-vector/rule-vector.hpp"
+#include "../models/stepper/stepper.hpp"
+#include "../output/output.hpp"
+#include "../terminal/terminal.hpp"
+#include "../utils/utils.hpp"
+
+using flags = std::unordered_map<std::string, std::string>;
+
+struct command
+{
+  std::string name;
+  std::string description;
+  std::vector<std::string> allowed_flags;
+  void (*execute)(const flags &);
+};
+
+static const std::vector<std::string> global_flags{"seed", "threads", "format", "output", "graph-cache", "result-cache", "stats", "trace"};
+static const std::vector<std::string> survey_flags{"size", "boundary", "samples"};
+static const std::vector<std::string> ca_flags{"size", "l-radius", "r-radius", "boundary", "rules"};
+
+static bool
+has_flag(const flags &parsed_flags, const std::string &name)
+{
+  return parsed_flags.find(name) != parsed_flags.end();
+}
+
+static const std::string &
+get_flag(const flags &parsed_flags, const std::string &name)
+{
+  if (!has_flag(parsed_flags, name))
+  {
+    throw cli::usage_error{"Missing required flag --" + name};
+  }
+
+  return parsed_flags.at(name);
+}
+
+static types::long_whole_num
+parse_whole_num(const std::string &str, const std::string &name)
+{
+  std::size_t num_parsed{};
+  types::long_whole_num value{};
+
+  try
+  {
+    value = std::stoul(str, &num_parsed);
+  }
+  catch (const std::exception &)
+  {
+    num_parsed = 0;
+  }
+
+  if (str.empty() || num_parsed != str.size() || str.at(0) == '-')
+  {
+    throw cli::usage_error{"Invalid value for --" + name + ": " + str};
+  }
+
+  return value;
+}
+
+static types::long_whole_num
+get_whole_num(const flags &parsed_flags, const std::string &name, types::long_whole_num default_value)
+{
+  if (!has_flag(parsed_flags, name))
+  {
+    return default_value;
+  }
+
+  return parse_whole_num(parsed_flags.at(name), name);
+}
+
+static types::short_whole_num
+get_radius(const flags &parsed_flags, const std::string &name)
+{
+  types::long_whole_num radius{get_whole_num(parsed_flags, name, 1)};
+
+  if (radius > std::numeric_limits<types::short_whole_num>::max())
+  {
+    throw cli::usage_error{"Invalid value for --" + name + ": " + parsed_flags.at(name)};
+  }
+
+  return static_cast<types::short_whole_num>(radius);
+}
+
+static types::boundary
+get_boundary(const flags &parsed_flags)
+{
+  const std::string &value{get_flag(parsed_flags, "boundary")};
+
+  if (value == "null" || value == "n")
+  {
+    return types::boundary::null;
+  }
+
+  if (value == "periodic" || value == "p")
+  {
+    return types::boundary::periodic;
+  }
+
+  throw cli::usage_error{"Invalid value for --boundary: " + value};
+}
+
+static types::rules
+parse_rules(const std::string &str, const std::string &name)
+{
+  types::rules rules{};
+  std::istringstream in_stream{str};
+  std::string current_rule{};
+
+  while (std::getline(in_stream, current_rule, ','))
+  {
+    rules.push_back(parse_whole_num(current_rule, name));
+  }
+
+  if (rules.empty())
+  {
+    throw cli::usage_error{"Empty rule list for --" + name};
+  }
+
+  return rules;
+}
+
+static types::short_whole_num
+get_num_cells(const flags &parsed_flags)
+{
+  types::long_whole_num num_cells{};
+
+  if (has_flag(parsed_flags, "size"))
+  {
+    num_cells = parse_whole_num(parsed_flags.at("size"), "size");
+  }
+  else if (has_flag(parsed_flags, "rules"))
+  {
+    num_cells = parse_rules(parsed_flags.at("rules"), "rules").size();
+  }
+  else
+  {
+    throw cli::usage_error{"Missing required flag --size"};
+  }
+
+  if (num_cells > models::binary_1d_ca::max_size)
+  {
+    throw std::invalid_argument{"Unsupported cellular automata size"};
+  }
+
+  return static_cast<types::short_whole_num>(num_cells);
+}
+
+static models::binary_1d_ca
+get_ca(const flags &parsed_flags)
+{
+  return models::binary_1d_ca{
+    get_num_cells(parsed_flags),
+    get_radius(parsed_flags, "l-radius"),
+    get_radius(parsed_flags, "r-radius"),
+    get_boundary(parsed_flags),
+    parse_rules(get_flag(parsed_flags, "rules"), "rules")
+  };
+}
+
+static void
+run_iso_check(const flags &parsed_flags)
+{
+  models::binary_1d_ca this_ca{get_ca(parsed_flags)};
+
+  models::binary_1d_ca other_ca{
+    this_ca.get_num_cells(),
+    this_ca.get_l_radius(),
+    this_ca.get_r_radius(),
+    this_ca.get_boundary(),
+    parse_rules(get_flag(parsed_flags, "other-rules"), "other-rules")
+  };
+
+  if (this_ca.is_isomorphic(other_ca))
+  {
+    utils::general::print_msg("Isomorphic", colors::cyan);
+  }
+  else
+  {
+    utils::general::print_msg("Not isomorphic", colors::blue);
+  }
+}
+
+// Configurations are given as one binary digit per cell, with cell 0 first.
+static void
+run_jump(const flags &parsed_flags)
+{
+  models::binary_1d_ca ca{get_ca(parsed_flags)};
+  const std::string &config_str{get_flag(parsed_flags, "config")};
+
+  if (config_str.size() != ca.get_num_cells() || config_str.find_first_not_of("01") != std::string::npos)
+  {
+    throw cli::usage_error{"Invalid value for --config: " + config_str};
+  }
+
+  ca.print_future_config(
+    static_cast<types::short_whole_num>(utils::number::parse_binary_str(config_str)),
+    parse_whole_num(get_flag(parsed_flags, "steps"), "steps")
+  );
+}
+
+// The spectrum of a uniform periodic CA is computed on its necklace graph, and so supports sizes beyond the regular CAs.
+// A single rule is repeated over --size cells.
+static void
+run_cycle_spectrum(const flags &parsed_flags)
+{
+  types::rules rules{parse_rules(get_flag(parsed_flags, "rules"), "rules")};
+  types::long_whole_num num_cells{get_whole_num(parsed_flags, "size", rules.size())};
+
+  if (std::adjacent_find(rules.begin(), rules.end(), std::not_equal_to<types::long_whole_num>{}) != rules.end())
+  {
+    throw cli::usage_error{"Cycle spectra are only supported for uniform rules"};
+  }
+
+  if (rules.size() != 1 && rules.size() != num_cells)
+  {
+    throw cli::usage_error{"Number of rules must be 1 or equal to number of cells"};
+  }
+
+  if (num_cells > models::necklace_graph::max_size)
+  {
+    throw std::invalid_argument{"Unsupported cellular automata size"};
+  }
+
+  models::necklace_graph{
+    static_cast<types::short_whole_num>(num_cells),
+    get_radius(parsed_flags, "l-radius"),
+    get_radius(parsed_flags, "r-radius"),
+    rules.at(0)
+  }.print_cycle_spectrum();
+}
+
+// The rules repeat along the lattice, and the starting configuration is random unless --config is given.
+static void
+run_hashlife(const flags &parsed_flags)
+{
+  types::rules rules{parse_rules(get_flag(parsed_flags, "rules"), "rules")};
+  types::long_whole_num num_cells{get_whole_num(parsed_flags, "size", rules.size())};
+  types::long_whole_num steps{parse_whole_num(get_flag(parsed_flags, "steps"), "steps")};
+
+  models::hashlife_1d ca{
+    num_cells,
+    get_radius(parsed_flags, "l-radius"),
+    get_radius(parsed_flags, "r-radius"),
+    rules
+  };
+
+  if (has_flag(parsed_flags, "config"))
+  {
+    const std::string &config_str{parsed_flags.at("config")};
+
+    if (config_str.size() != num_cells || config_str.find_first_not_of("01") != std::string::npos)
+    {
+      throw cli::usage_error{"Invalid value for --config: " + config_str};
+    }
+
+    ca.set_config(config_str);
+  }
+  else
+  {
+    ca.randomize_config();
+  }
+
+  ca.update_config(steps);
+  ca.print_summary(steps);
+}
+
+static models::stepper_kernel
+get_stepper_kernel(const std::string &value)
+{
+  static const std::unordered_map<std::string, models::stepper_kernel> kernels{
+    {"scalar", models::stepper_kernel::scalar},
+    {"bitsliced", models::stepper_kernel::bitsliced},
+    {"lookup-8", models::stepper_kernel::lookup_8},
+    {"lookup-16", models::stepper_kernel::lookup_16},
+    {"compiled", models::stepper_kernel::compiled}
+  };
+
+  auto found{kernels.find(value)};
+
+  if (found == kernels.end())
+  {
+    throw cli::usage_error{"Invalid value for --kernel: " + value};
+  }
+
+  return found->second;
+}
+
+// Generated steppers are cached in the user's cache directory unless --jit-cache is given.
+// A shared directory such as /tmp would let other users plant libraries that this process loads.
+// Missing parents of the directory are created private to the user, along with it.
+static std::string
+get_jit_cache_directory(const flags &parsed_flags)
+{
+  if (has_flag(parsed_flags, "jit-cache"))
+  {
+    return parsed_flags.at("jit-cache");
+  }
+
+  const char *cache_home{std::getenv("XDG_CACHE_HOME")};
+
+  if (cache_home != nullptr && *cache_home != '\0')
+  {
+    return std::string{cache_home} + "/ca-jit";
+  }
+
+  const char *home{std::getenv("HOME")};
+
+  if (home == nullptr || *home == '\0')
+  {
+    throw cli::usage_error{"Missing required flag --jit-cache, as HOME isn't set"};
+  }
+
+  return std::string{home} + "/.cache/ca-jit";
+}
+
+template <typename stepper_type>
+static void
+run_steps(const stepper_type &stepper, std::vector<types::long_whole_num> &config, types::long_whole_num steps)
+{
+  std::vector<types::long_whole_num> next_config{};
+
+  for (types::long_whole_num i{}; i < steps; i++)
+  {
+    stepper.step(config, next_config);
+    config.swap(next_config);
+  }
+}
+
+// The rules repeat along the lattice, and the starting configuration is random unless --config is given.
+static void
+run_stepper(const flags &parsed_flags)
+{
+  types::rules rules{parse_rules(get_flag(parsed_flags, "rules"), "rules")};
+  types::long_whole_num num_cells{get_whole_num(parsed_flags, "size", rules.size())};
+  types::long_whole_num steps{parse_whole_num(get_flag(parsed_flags, "steps"), "steps")};
+  types::short_whole_num l_radius{get_radius(parsed_flags, "l-radius")};
+  types::short_whole_num r_radius{get_radius(parsed_flags, "r-radius")};
+  types::boundary boundary{get_boundary(parsed_flags)};
+  std::string kernel{has_flag(parsed_flags, "kernel") ? parsed_flags.at("kernel") : "compiled"};
+  std::vector<types::long_whole_num> config{};
+
+  if (has_flag(parsed_flags, "config"))
+  {
+    const std::string &config_str{parsed_flags.at("config")};
+
+    if (config_str.size() != num_cells || config_str.find_first_not_of("01") != std::string::npos)
+    {
+      throw cli::usage_error{"Invalid value for --config: " + config_str};
+    }
+
+    config = models::stepper::pack(config_str);
+  }
+  else
+  {
+    config.resize((num_cells + 63) / 64);
+
+    for (auto &word : config)
+    {
+      word = utils::random::next();
+    }
+  }
+
+  if (kernel == "jit")
+  {
+    run_steps(models::jit_stepper{num_cells, l_radius, r_radius, boundary, rules, get_jit_cache_directory(parsed_flags)}, config, steps);
+  }
+  else
+  {
+    run_steps(models::stepper{num_cells, l_radius, r_radius, boundary, rules, get_stepper_kernel(kernel)}, config, steps);
+  }
+
+  std::string config_str{models::stepper::unpack(config, num_cells)};
+  std::string steps_str{std::to_string(steps)};
+  types::long_whole_num num_ones{static_cast<types::long_whole_num>(std::count(config_str.begin(), config_str.end(), '1'))};
+
+  std::vector<std::pair<std::string, types::short_whole_num>> headings{
+    std::make_pair<std::string, types::short_whole_num>("Cells", 10),
+    std::make_pair<std::string, types::short_whole_num>("Steps", std::max(static_cast<types::num>(steps_str.size()), 5)),
+    std::make_pair<std::string, types::short_whole_num>("Ones", 10)
+  };
+
+  std::vector<std::pair<std::string, types::short_whole_num>> entries{
+    std::make_pair<std::string, types::short_whole_num>(std::to_string(num_cells), 10),
+    std::make_pair<std::string, types::short_whole_num>(
+      std::string{steps_str}, std::max(static_cast<types::num>(steps_str.size()), 5)
+    ),
+    std::make_pair<std::string, types::short_whole_num>(std::to_string(num_ones), 10)
+  };
+
+  utils::general::print_header(headings, {
+    output::field_type::number,
+    output::field_type::number,
+    output::field_type::number
+  });
+  utils::general::print_row(entries);
+
+  // Long lattices would flood the terminal, so only short configurations are printed.
+  if (num_cells <= 128)
+  {
+    utils::general::print_msg(config_str, colors::cyan);
+  }
+}
+
+static const std::vector<command> commands{
+  {
+    "complementable",
+    "Print complementable reversible linear ECAs",
+    {"size", "boundary"},
+    [](const flags &parsed_flags) {
+      models::rule_vector::print_complementable_rule_vectors(
+        get_num_cells(parsed_flags), get_boundary(parsed_flags)
+      );
+    }
+  },
+  {
+    "linear-rpi-census",
+    "Print linear ECAs with non-trivial reversed pseudo-isomorphisms",
+    {"size", "boundary"},
+    [](const flags &parsed_flags) {
+      models::binary_1d_ca_manager::print_reversed_pseudo_isomorphable_ecas(
+        get_num_cells(parsed_flags), get_boundary(parsed_flags), true, 0
+      );
+    }
+  },
+  {
+    "rpi-census",
+    "Print random ECAs with non-trivial reversed pseudo-isomorphisms",
+    survey_flags,
+    [](const flags &parsed_flags) {
+      models::binary_1d_ca_manager::print_reversed_pseudo_isomorphable_ecas(
+        get_num_cells(parsed_flags), get_boundary(parsed_flags), false, get_whole_num(parsed_flags, "samples", 1000)
+      );
+    }
+  },
+  {
+    "single-cycle",
+    "Print random single cycle reversible ECAs",
+    survey_flags,
+    [](const flags &parsed_flags) {
+      models::binary_1d_ca_manager::print_single_cycle_reversible_ecas(
+        get_num_cells(parsed_flags), get_boundary(parsed_flags), get_whole_num(parsed_flags, "samples", 1000)
+      );
+    }
+  },
+  {
+    "reversible",
+    "Print random reversible ECAs",
+    survey_flags,
+    [](const flags &parsed_flags) {
+      models::binary_1d_ca_manager::print_reversible_ecas(
+        get_num_cells(parsed_flags), get_boundary(parsed_flags), get_whole_num(parsed_flags, "samples", 100)
+      );
+    }
+  },
+  {
+    "graph",
+    "Print transition graph",
+    ca_flags,
+    [](const flags &parsed_flags) {
+      get_ca(parsed_flags).print_transition_graph();
+    }
+  },
+  {
+    "details",
+    "Print CA details",
+    ca_flags,
+    [](const flags &parsed_flags) {
+      get_ca(parsed_flags).print_details();
+    }
+  },
+  {
+    "isomorphisms",
+    "Print isomorphisms (*)",
+    ca_flags,
+    [](const flags &parsed_flags) {
+      get_ca(parsed_flags).print_isomorphisms();
+    }
+  },
+  {
+    "iso-check",
+    "Check isomorphism with the CA given by --other-rules (*)",
+    {"size", "l-radius", "r-radius", "boundary", "rules", "other-rules"},
+    run_iso_check
+  },
+  {
+    "complemented",
+    "Print complemented isomorphisms",
+    ca_flags,
+    [](const flags &parsed_flags) {
+      get_ca(parsed_flags).print_complemented_isomorphisms();
+    }
+  },
+  {
+    "rpi",
+    "Print reversed pseudo-isomorphisms",
+    ca_flags,
+    [](const flags &parsed_flags) {
+      get_ca(parsed_flags).print_reversed_pseudo_isomorphisms();
+    }
+  },
+  {
+    "matrix",
+    "Print characteristic matrix",
+    ca_flags,
+    [](const flags &parsed_flags) {
+      get_ca(parsed_flags).print_characterisitc_matrix();
+    }
+  },
+  {
+    "polynomial",
+    "Print characteristic polynomial",
+    ca_flags,
+    [](const flags &parsed_flags) {
+      get_ca(parsed_flags).print_characterisitc_polynomial();
+    }
+  },
+  {
+    "rmt-complement",
+    "Print CAs by complementing rules based on equivalent RMTs",
+    ca_flags,
+    [](const flags &parsed_flags) {
+      get_ca(parsed_flags).print_rmts_complemented_rules();
+    }
+  },
+  {
+    "tweak",
+    "Print affected configurations by tweaking rules",
+    ca_flags,
+    [](const flags &parsed_flags) {
+      get_ca(parsed_flags).tweak_rules();
+    }
+  },
+  {
+    "sn-maps",
+    "Print state-neighborhood maps",
+    ca_flags,
+    [](const flags &parsed_flags) {
+      get_ca(parsed_flags).print_sn_maps();
+    }
+  },
+  {
+    "jump",
+    "Print the configuration after --steps steps from --config",
+    {"size", "l-radius", "r-radius", "boundary", "rules", "config", "steps"},
+    run_jump
+  },
+  {
+    "hashlife",
+    "Run a periodic CA of up to 2^20 cells for --steps steps, with HashLife",
+    {"size", "l-radius", "r-radius", "rules", "config", "steps"},
+    run_hashlife
+  },
+  {
+    "formulas",
+    "Print the Boolean formula of every rule",
+    {"l-radius", "r-radius", "rules"},
+    [](const flags &parsed_flags) {
+      models::rule_program::print_formulas(
+        get_radius(parsed_flags, "l-radius"),
+        get_radius(parsed_flags, "r-radius"),
+        parse_rules(get_flag(parsed_flags, "rules"), "rules")
+      );
+    }
+  },
+  {
+    "run",
+    "Run a CA of up to 2^30 cells for --steps steps, with the stepper given by --kernel",
+    {"size", "l-radius", "r-radius", "boundary", "rules", "config", "steps", "kernel", "jit-cache"},
+    run_stepper
+  },
+  {
+    "cycle-spectrum",
+    "Print cycle spectrum of a uniform periodic CA (up to 24 cells)",
+    {"size", "l-radius", "r-radius", "rules"},
+    run_cycle_spectrum
+  }
+};
+
+static void
+print_usage(std::ostream &out_stream)
+{
+  out_stream << "Usage: main [<command> [--<flag> <value>]...]\n";
+  out_stream << "Without a command, the interactive menu is started.\n\n";
+  out_stream << "Commands:\n";
+
+  for (const auto &current_command : commands)
+  {
+    out_stream << "  " << current_command.name;
+    out_stream << std::string(20 - current_command.name.size(), ' ');
+    out_stream << current_command.description << "\n";
+  }
+
+  out_stream << "\n";
+  out_stream << "Flags:\n";
+  out_stream << "  --size <n>            No. of cells (inferred from --rules when omitted)\n";
+  out_stream << "  --l-radius <r>        Left radius (default: 1)\n";
+  out_stream << "  --r-radius <r>        Right radius (default: 1)\n";
+  out_stream << "  --boundary <b>        null | periodic\n";
+  out_stream << "  --rules <r1,r2,...>   Rule for every cell\n";
+  out_stream << "  --other-rules <...>   Rules of the CA to compare against (iso-check)\n";
+  out_stream << "  --config <bits>       Starting configuration, one digit per cell (jump, hashlife, run)\n";
+  out_stream << "  --steps <t>           No. of steps to jump ahead (jump, hashlife, run)\n";
+  out_stream << "  --kernel <k>          scalar | bitsliced | lookup-8 | lookup-16 | compiled | jit (default: compiled)\n";
+  out_stream << "  --jit-cache <dir>     Directory of the libraries compiled for the jit kernel (default: $XDG_CACHE_HOME/ca-jit or ~/.cache/ca-jit)\n";
+  out_stream << "  --samples <n>         No. of random samples for surveys\n";
+  out_stream << "  --seed <n>            Random seed (default: current time)\n";
+  out_stream << "  --threads <n>         No. of OpenMP threads (default: all cores)\n";
+  out_stream << "  --format <f>          table | csv | jsonl | binary (default: table)\n";
+  out_stream << "  --output <path>       Write results to a file instead of stdout\n";
+  out_stream << "  --graph-cache <dir>   Reuse transition graphs stored in a directory\n";
+  out_stream << "  --result-cache <dir>  Reuse analysis results stored in a directory\n";
+  out_stream << "  --stats <path>        Write the instrumentation report to a file, or to stderr for -\n";
+  out_stream << "  --trace <path>        Write a timeline of the threads to a file, in the Chrome trace format\n";
+  out_stream << "\n";
+  out_stream << "Exit status is 0 on success, 1 if the analysis fails and 2 for invalid usage.\n";
+}
+
+static flags
+parse_flags(const command &current_command, types::num argc, char **argv)
+{
+  flags parsed_flags{};
+
+  for (types::num i{2}; i < argc; i += 2)
+  {
+    std::string current_arg{argv[i]};
+
+    if (current_arg.rfind("--", 0) != 0 || current_arg.size() == 2)
+    {
+      throw cli::usage_error{"Unexpected argument: " + current_arg};
+    }
+
+    std::string name{current_arg.substr(2)};
+
+    bool is_allowed{
+      std::find(current_command.allowed_flags.begin(), current_command.allowed_flags.end(), name) != current_command.allowed_flags.end() ||
+      std::find(global_flags.begin(), global_flags.end(), name) != global_flags.end()
+    };
+
+    if (!is_allowed)
+    {
+      throw cli::usage_error{"Unknown flag for " + current_command.name + ": " + current_arg};
+    }
+
+    if (i + 1 >= argc)
+    {
+      throw cli::usage_error{"Missing value for " + current_arg};
+    }
+
+    parsed_flags[name] = argv[i + 1];
+  }
+
+  return parsed_flags;
+}
+
+static void
+apply_global_flags(const flags &parsed_flags)
+{
+  if (has_flag(parsed_flags, "format") || has_flag(parsed_flags, "output"))
+  {
+    output::format format{output::format::table};
+
+    if (has_flag(parsed_flags, "format"))
+    {
+      try
+      {
+        format = output::parse_format(parsed_flags.at("format"));
+      }
+      catch (const std::invalid_argument &err)
+      {
+        throw cli::usage_error{err.what()};
+      }
+    }
+
+    output::set_sink(format, has_flag(parsed_flags, "output") ? parsed_flags.at("output") : "");
+  }
+
+  if (has_flag(parsed_flags, "graph-cache"))
+  {
+    models::graph_cache::set_directory(parsed_flags.at("graph-cache"));
+  }
+
+  if (has_flag(parsed_flags, "result-cache"))
+  {
+    models::result_cache::set_directory(parsed_flags.at("result-cache"));
+  }
+
+  if (has_flag(parsed_flags, "seed"))
+  {
+    utils::random::seed(parse_whole_num(parsed_flags.at("seed"), "seed"));
+  }
+
+  if (has_flag(parsed_flags, "threads"))
+  {
+    types::long_whole_num num_threads{parse_whole_num(parsed_flags.at("threads"), "threads")};
+
+    if (num_threads == 0)
+    {
+      throw cli::usage_error{"Invalid value for --threads: 0"};
+    }
+
+    omp_set_num_threads(static_cast<types::num>(num_threads));
+  }
+}
+
+static void
+write_stats(const std::string &path)
+{
+  if (path == "-")
+  {
+    instrument::report(stderr);
+    return;
+  }
+
+  std::FILE *file{std::fopen(path.c_str(), "w")};
+
+  if (file == nullptr)
+  {
+    throw std::runtime_error{"Cannot open " + path};
+  }
+
+  instrument::report(file);
+  std::fclose(file);
+}
+
+static void
+write_trace(const std::string &path)
+{
+  std::FILE *file{std::fopen(path.c_str(), "w")};
+
+  if (file == nullptr)
+  {
+    throw std::runtime_error{"Cannot open " + path};
+  }
+
+  instrument::write_trace(file);
+  std::fclose(file);
+}
+
+// An error in a step run after the command is reported, but doesn't replace the exit code of an earlier error.
+static void
+run_final_step(const std::function<void()> &step, types::num &exit_code)
+{
+  try
+  {
+    step();
+  }
+  catch (const std::exception &err)
+  {
+    std::cerr << "ERR: " << err.what() << "\n";
+    exit_code = exit_code == cli::exit_success ? cli::exit_failure : exit_code;
+  }
+}
+
+types::num
+cli::run(types::num argc, char **argv)
+{
+  std::string name{argv[1]};
+
+  if (name == "help" || name == "--help" || name == "-h")
+  {
+    print_usage(std::cout);
+    return cli::exit_success;
+  }
+
+  auto current_command{std::find_if(commands.begin(), commands.end(), [&name](const command &obj) {
+    return obj.name == name;
+  })};
+
+  flags parsed_flags{};
+  types::num exit_code{cli::exit_success};
+
+  try
+  {
+    if (current_command == commands.end())
+    {
+      throw cli::usage_error{"Unknown command: " + name};
+    }
+
+    parsed_flags = parse_flags(*current_command, argc, argv);
+    apply_global_flags(parsed_flags);
+
+    if (has_flag(parsed_flags, "trace"))
+    {
+      instrument::start_trace();
+    }
+
+    current_command->execute(parsed_flags);
+  }
+  catch (const cli::usage_error &err)
+  {
+    std::cerr << "ERR: " << err.what() << "\n";
+    std::cerr << "Run `main help` for usage\n";
+    exit_code = cli::exit_usage;
+  }
+  catch (const std::exception &err)
+  {
+    std::cerr << "ERR: " << err.what() << "\n";
+    exit_code = cli::exit_failure;
+  }
+
+  // The rows written so far, the stats and the trace matter most when a command fails, so they are written either way.
+  instrument::stop_trace();
+  run_final_step([]() { output::flush(); }, exit_code);
+
+  if (has_flag(parsed_flags, "stats"))
+  {
+    run_final_step([&parsed_flags]() { write_stats(parsed_flags.at("stats")); }, exit_code);
+  }
+
+  if (has_flag(parsed_flags, "trace"))
+  {
+    run_final_step([&parsed_flags]() { write_trace(parsed_flags.at("trace")); }, exit_code);
+  }
+
+  return exit_code;
+}
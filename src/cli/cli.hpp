@@ -0,0 +1,26 @@
+#ifndef __CLI__
+#define __CLI__
+
+#include <stdexcept>
+#include <string>
+
+#include "../types/types.hpp"
+
+namespace cli
+{
+  // Raised for malformed command lines, so that they can be told apart from failures of the analyses themselves.
+  class usage_error : public std::invalid_argument
+  {
+    public:
+      using std::invalid_argument::invalid_argument;
+  };
+
+  static const types::num exit_success{0};
+  static const types::num exit_failure{1};
+  static const types::num exit_usage{2};
+
+  types::num
+  run(types::num argc, char **argv);
+}
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef __INSTRUMENT__
+#define __INSTRUMENT__
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+#include "../types/types.hpp"
+
+// Instrumentation of the hot paths, compiled in only when `CA_INSTRUMENT` is defined (`make INSTRUMENT=1`).
+// Otherwise the macros below expand to nothing, and the instrumented code is identical to the uninstrumented one.
+//
+// Every thread records into its own block of atomics, which only it writes to, so recording never contends.
+// The blocks of all the threads are summed up when a report is printed.
+//
+// With `CA_PERF_COUNTERS` as well (`make INSTRUMENT=1 PERF=1`), every timer also reads the hardware counters of its thread.
+// The counters are opened with `perf_event_open`, as one group per thread, so that they are scheduled onto the PMU together.
+// Where they can't be opened, say for lack of permissions or of a PMU in virtual machines, they are reported as n/a.
+//
+// With `CA_ALLOC_PROFILE` (`make ALLOC_PROFILE=1`), the global operator new and delete are replaced to track every allocation.
+// Allocations are attributed to the innermost phase being timed on the allocating thread.
+//
+// Instrumented builds can also record a timeline, once `start_trace` is called, which is exported in the Chrome trace event format.
+// The outermost phase of every thread, the chunks of the parallel loops, and the waits for and holds of critical sections are traced.
+// Consecutive iterations run by a thread are merged into a single chunk, so that the size of a trace stays independent of the loop counts.
+
+#if (defined(CA_PERF_COUNTERS) || defined(CA_ALLOC_PROFILE)) && !defined(CA_INSTRUMENT)
+  #define CA_INSTRUMENT
+#endif
+
+#ifdef CA_INSTRUMENT
+  #define CA_INSTRUMENT_CONCAT_IMPL(x, y) x##y
+  #define CA_INSTRUMENT_CONCAT(x, y) CA_INSTRUMENT_CONCAT_IMPL(x, y)
+  #define CA_SCOPED_TIMER(name) instrument::scoped_timer CA_INSTRUMENT_CONCAT(ca_scoped_timer_, __LINE__){instrument::phase::name}
+  #define CA_COUNT(name, value) instrument::add(instrument::counter::name, value)
+  #define CA_TRACE_CHUNK(name, index) instrument::trace_chunk CA_INSTRUMENT_CONCAT(ca_trace_chunk_, __LINE__){name, index}
+  #define CA_TRACE_LOCK_REQUEST(lock) types::long_whole_num ca_trace_request_##lock{instrument::get_trace_time()}
+  #define CA_TRACE_LOCK_ACQUIRED(lock) instrument::trace_lock ca_trace_lock_##lock{#lock, ca_trace_request_##lock}
+#else
+  #define CA_SCOPED_TIMER(name)
+  #define CA_COUNT(name, value)
+  #define CA_TRACE_CHUNK(name, index)
+  #define CA_TRACE_LOCK_REQUEST(lock)
+  #define CA_TRACE_LOCK_ACQUIRED(lock)
+#endif
+
+namespace instrument
+{
+  enum phase
+  {
+    construct,
+    fill_transition_graph,
+    fill_sn_maps,
+    get_cycles,
+    extract_rules,
+    is_isomorphic,
+    print_isomorphisms,
+    reversed_pseudo_isomorphisms,
+    isomorphic_complements,
+    complementable_rule_vectors,
+    hashlife_jump,
+    hashlife_gc,
+    hashlife_step,
+    stepper_build_table,
+    survey_generate,
+    survey_analyse,
+    output,
+    num_phases
+  };
+
+  enum counter
+  {
+    cas_constructed,
+    permutations_tried,
+    permutations_pruned,
+    extract_rules_calls,
+    subsets_examined,
+    hashlife_hits,
+    hashlife_misses,
+    stepper_table_hits,
+    stepper_table_misses,
+    rows_written,
+    num_counters
+  };
+
+  enum hw_event
+  {
+    cycles,
+    instructions,
+    cache_misses,
+    branch_misses,
+    num_hw_events
+  };
+
+  struct thread_record
+  {
+    std::atomic<types::long_whole_num> phase_calls[phase::num_phases]{};
+    std::atomic<types::long_whole_num> phase_ns[phase::num_phases]{};
+    std::atomic<types::long_whole_num> phase_hw_counts[phase::num_phases][hw_event::num_hw_events]{};
+    std::atomic<types::long_whole_num> counters[counter::num_counters]{};
+    types::num perf_fd{-1};
+  };
+
+  static const bool is_enabled{
+    #ifdef CA_INSTRUMENT
+      true
+    #else
+      false
+    #endif
+  };
+
+  thread_record &
+  get_thread_record();
+
+  inline void
+  add(instrument::counter counter, types::long_whole_num value)
+  {
+    std::atomic<types::long_whole_num> &current_counter{instrument::get_thread_record().counters[counter]};
+    current_counter.store(current_counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+
+  const char *
+  get_phase_name(instrument::phase current_phase);
+
+  // The innermost phase being timed on the calling thread, or `num_phases` outside of all the phases.
+  instrument::phase
+  get_current_phase();
+
+  // Times are inclusive, so a phase nested in another is counted in both.
+  class scoped_timer
+  {
+    private:
+      instrument::phase current_phase{};
+      instrument::phase previous_phase{};
+      std::chrono::steady_clock::time_point start{};
+      types::long_whole_num hw_start[hw_event::num_hw_events]{};
+      bool has_hw_counts{};
+
+    public:
+      explicit scoped_timer(instrument::phase current_phase);
+
+      scoped_timer(const scoped_timer &other) = delete;
+
+      scoped_timer &
+      operator=(const scoped_timer &other) = delete;
+
+      ~scoped_timer();
+  };
+
+  void
+  reset();
+
+  void
+  report(std::FILE *file);
+
+  void
+  reset_allocations();
+
+  // Nanoseconds on the steady clock.
+  types::long_whole_num
+  get_trace_time();
+
+  bool
+  is_tracing();
+
+  // Events are copied into a buffer of the calling thread, so `name` and `category` must be string literals.
+  void
+  add_trace_event(
+    const char *name,
+    const char *category,
+    types::long_whole_num start,
+    types::long_whole_num end,
+    types::long_whole_num first_index = 0,
+    types::long_whole_num last_index = 0
+  );
+
+  // One iteration of a parallel loop, which is merged with the previous iteration of the thread when they are consecutive.
+  class trace_chunk
+  {
+    private:
+      const char *name{};
+      types::long_whole_num index{};
+      types::long_whole_num start{};
+
+    public:
+      trace_chunk(const char *name, types::long_whole_num index);
+
+      trace_chunk(const trace_chunk &other) = delete;
+
+      trace_chunk &
+      operator=(const trace_chunk &other) = delete;
+
+      ~trace_chunk();
+  };
+
+  // Constructed first thing in a critical section, with the time the section was requested at.
+  // The wait is recorded right away, and the hold once the section is left.
+  class trace_lock
+  {
+    private:
+      const char *name{};
+      types::long_whole_num start{};
+
+    public:
+      trace_lock(const char *name, types::long_whole_num request_time);
+
+      trace_lock(const trace_lock &other) = delete;
+
+      trace_lock &
+      operator=(const trace_lock &other) = delete;
+
+      ~trace_lock();
+  };
+
+  // Clears the events recorded so far, and starts recording.
+  void
+  start_trace();
+
+  void
+  stop_trace();
+
+  void
+  write_trace(std::FILE *file);
+
+  void
+  report_allocations(std::FILE *file);
+}
+
+#endif
@@ -0,0 +1,238 @@
+#include "../instrument.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Every block is allocated with a header in front, holding its size and the phase it was allocated in.
+// So a free is charged to the phase that made the allocation, whichever thread or phase releases it.
+// The header is as large as the strictest fundamental alignment, so that the blocks handed out stay aligned.
+//
+// Over-aligned allocations go to the default `operator new(std::size_t, std::align_val_t)`, and aren't tracked.
+
+#ifdef CA_ALLOC_PROFILE
+
+struct alignas(std::max_align_t) alloc_header
+{
+  std::size_t size{};
+  types::whole_num phase{};
+};
+
+struct alloc_stats
+{
+  std::atomic<types::long_whole_num> num_allocs{};
+  std::atomic<types::long_whole_num> num_frees{};
+  std::atomic<types::long_whole_num> num_bytes{};
+  std::atomic<types::long_whole_num> live_bytes{};
+  std::atomic<types::long_whole_num> peak_bytes{};
+};
+
+// The last entry collects the allocations made outside of all the phases.
+static alloc_stats phase_stats[instrument::phase::num_phases + 1]{};
+static alloc_stats total_stats{};
+
+// Guards against tracking the allocations made while tracking, if any.
+static thread_local bool is_tracking{};
+
+static void
+update_peak(std::atomic<types::long_whole_num> &peak_bytes, types::long_whole_num live_bytes)
+{
+  types::long_whole_num current_peak{peak_bytes.load(std::memory_order_relaxed)};
+
+  while (live_bytes > current_peak && !peak_bytes.compare_exchange_weak(current_peak, live_bytes, std::memory_order_relaxed))
+  {
+  }
+}
+
+static void
+record_alloc(alloc_stats &stats, std::size_t size)
+{
+  stats.num_allocs.fetch_add(1, std::memory_order_relaxed);
+  stats.num_bytes.fetch_add(size, std::memory_order_relaxed);
+  update_peak(stats.peak_bytes, stats.live_bytes.fetch_add(size, std::memory_order_relaxed) + size);
+}
+
+static void
+record_free(alloc_stats &stats, std::size_t size)
+{
+  stats.num_frees.fetch_add(1, std::memory_order_relaxed);
+  stats.live_bytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+static void *
+allocate(std::size_t size) noexcept
+{
+  alloc_header *header{static_cast<alloc_header *>(std::malloc(sizeof(alloc_header) + size))};
+
+  if (header == nullptr)
+  {
+    return nullptr;
+  }
+
+  header->size = size;
+  header->phase = instrument::phase::num_phases;
+
+  if (!is_tracking)
+  {
+    is_tracking = true;
+    header->phase = instrument::get_current_phase();
+    record_alloc(phase_stats[header->phase], size);
+    record_alloc(total_stats, size);
+    is_tracking = false;
+  }
+
+  return header + 1;
+}
+
+static void
+deallocate(void *ptr) noexcept
+{
+  if (ptr == nullptr)
+  {
+    return;
+  }
+
+  alloc_header *header{static_cast<alloc_header *>(ptr) - 1};
+  record_free(phase_stats[header->phase], header->size);
+  record_free(total_stats, header->size);
+  std::free(header);
+}
+
+static void *
+allocate_or_throw(std::size_t size)
+{
+  void *ptr{allocate(size)};
+
+  if (ptr == nullptr)
+  {
+    throw std::bad_alloc{};
+  }
+
+  return ptr;
+}
+
+void *
+operator new(std::size_t size)
+{
+  return allocate_or_throw(size);
+}
+
+void *
+operator new[](std::size_t size)
+{
+  return allocate_or_throw(size);
+}
+
+void *
+operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+  return allocate(size);
+}
+
+void *
+operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+  return allocate(size);
+}
+
+void
+operator delete(void *ptr) noexcept
+{
+  deallocate(ptr);
+}
+
+void
+operator delete[](void *ptr) noexcept
+{
+  deallocate(ptr);
+}
+
+void
+operator delete(void *ptr, std::size_t) noexcept
+{
+  deallocate(ptr);
+}
+
+void
+operator delete[](void *ptr, std::size_t) noexcept
+{
+  deallocate(ptr);
+}
+
+void
+operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+  deallocate(ptr);
+}
+
+void
+operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+  deallocate(ptr);
+}
+
+static void
+reset_stats(alloc_stats &stats)
+{
+  stats.num_allocs.store(0, std::memory_order_relaxed);
+  stats.num_frees.store(0, std::memory_order_relaxed);
+  stats.num_bytes.store(0, std::memory_order_relaxed);
+  stats.peak_bytes.store(stats.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+static void
+print_stats(std::FILE *file, const char *name, const alloc_stats &stats)
+{
+  std::fprintf(
+    file,
+    "%-30s %12lu %12lu %16lu %16lu %16lu\n",
+    name,
+    stats.num_allocs.load(std::memory_order_relaxed),
+    stats.num_frees.load(std::memory_order_relaxed),
+    stats.num_bytes.load(std::memory_order_relaxed),
+    stats.peak_bytes.load(std::memory_order_relaxed),
+    stats.live_bytes.load(std::memory_order_relaxed)
+  );
+}
+
+// Live bytes are kept across resets, as the blocks allocated before a reset may still be freed after it.
+void
+instrument::reset_allocations()
+{
+  for (auto &stats : phase_stats)
+  {
+    reset_stats(stats);
+  }
+
+  reset_stats(total_stats);
+}
+
+void
+instrument::report_allocations(std::FILE *file)
+{
+  std::fprintf(file, "\n%-30s %12s %12s %16s %16s %16s\n", "Allocations", "Allocs", "Frees", "Bytes", "Peak live bytes", "Live bytes");
+
+  for (types::whole_num i{}; i <= instrument::phase::num_phases; i++)
+  {
+    if (phase_stats[i].num_allocs.load(std::memory_order_relaxed) > 0)
+    {
+      print_stats(file, instrument::get_phase_name(static_cast<instrument::phase>(i)), phase_stats[i]);
+    }
+  }
+
+  print_stats(file, "total", total_stats);
+}
+
+#else
+
+void
+instrument::reset_allocations()
+{
+}
+
+void
+instrument::report_allocations(std::FILE *file)
+{
+}
+
+#endif
@@ -0,0 +1,399 @@
+#include "../instrument.hpp"
+
+#ifdef CA_PERF_COUNTERS
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+static const char *phase_names[instrument::phase::num_phases]{
+  "construct",
+  "fill_transition_graph",
+  "fill_sn_maps",
+  "get_cycles",
+  "extract_rules",
+  "is_isomorphic",
+  "print_isomorphisms",
+  "reversed_pseudo_isomorphisms",
+  "isomorphic_complements",
+  "complementable_rule_vectors",
+  "hashlife_jump",
+  "hashlife_gc",
+  "hashlife_step",
+  "stepper_build_table",
+  "survey_generate",
+  "survey_analyse",
+  "output"
+};
+
+static const char *counter_names[instrument::counter::num_counters]{
+  "cas_constructed",
+  "permutations_tried",
+  "permutations_pruned",
+  "extract_rules_calls",
+  "subsets_examined",
+  "hashlife_hits",
+  "hashlife_misses",
+  "stepper_table_hits",
+  "stepper_table_misses",
+  "rows_written"
+};
+
+static const char *hw_event_names[instrument::hw_event::num_hw_events]{
+  "Cycles",
+  "Instructions",
+  "Cache misses",
+  "Branch misses"
+};
+
+// Records outlive their threads, so that the work of threads that have exited is still reported.
+static std::mutex records_mutex{};
+static std::vector<std::unique_ptr<instrument::thread_record>> thread_records{};
+static std::string perf_error{};
+static thread_local instrument::phase current_phase{instrument::phase::num_phases};
+
+#ifdef CA_PERF_COUNTERS
+static types::num
+open_perf_counter(types::long_whole_num config, types::num group_fd)
+{
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = group_fd == -1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+
+  return static_cast<types::num>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+// Counts the calling thread only, on whichever CPU it runs.
+// The first failure is remembered, to be shown in the report.
+static types::num
+open_perf_group()
+{
+  static const types::long_whole_num configs[instrument::hw_event::num_hw_events]{
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+  };
+
+  std::vector<types::num> fds{};
+
+  for (const auto &config : configs)
+  {
+    types::num fd{open_perf_counter(config, fds.empty() ? -1 : fds.front())};
+
+    if (fd < 0)
+    {
+      if (perf_error.empty())
+      {
+        perf_error = std::strerror(errno);
+      }
+
+      for (const auto &current_fd : fds)
+      {
+        close(current_fd);
+      }
+
+      return -1;
+    }
+
+    fds.push_back(fd);
+  }
+
+  ioctl(fds.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(fds.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+  return fds.front();
+}
+
+static bool
+read_perf_group(types::num fd, types::long_whole_num (&values)[instrument::hw_event::num_hw_events])
+{
+  std::uint64_t buffer[1 + instrument::hw_event::num_hw_events]{};
+
+  if (read(fd, buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer)))
+  {
+    return false;
+  }
+
+  for (types::whole_num i{}; i < instrument::hw_event::num_hw_events; i++)
+  {
+    values[i] = buffer[1 + i];
+  }
+
+  return true;
+}
+#endif
+
+static void
+add_to(std::atomic<types::long_whole_num> &value, types::long_whole_num delta)
+{
+  value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+instrument::thread_record &
+instrument::get_thread_record()
+{
+  static thread_local instrument::thread_record *record{};
+
+  if (record == nullptr)
+  {
+    std::lock_guard<std::mutex> lock{records_mutex};
+    thread_records.push_back(std::make_unique<instrument::thread_record>());
+    record = thread_records.back().get();
+
+    #ifdef CA_PERF_COUNTERS
+      record->perf_fd = open_perf_group();
+    #endif
+  }
+
+  return *record;
+}
+
+const char *
+instrument::get_phase_name(instrument::phase current_phase)
+{
+  return current_phase < instrument::phase::num_phases ? phase_names[current_phase] : "(untimed)";
+}
+
+instrument::phase
+instrument::get_current_phase()
+{
+  return current_phase;
+}
+
+instrument::scoped_timer::scoped_timer(instrument::phase current_phase)
+{
+  this->current_phase = current_phase;
+  this->previous_phase = ::current_phase;
+  ::current_phase = current_phase;
+
+  #ifdef CA_PERF_COUNTERS
+    instrument::thread_record &record{instrument::get_thread_record()};
+    this->has_hw_counts = record.perf_fd >= 0 && read_perf_group(record.perf_fd, this->hw_start);
+  #endif
+
+  this->start = std::chrono::steady_clock::now();
+}
+
+instrument::scoped_timer::~scoped_timer()
+{
+  types::long_whole_num elapsed_ns{static_cast<types::long_whole_num>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start).count()
+  )};
+
+  ::current_phase = this->previous_phase;
+
+  // Only the outermost phases are traced, as the nested ones can run once per permutation.
+  // Workers don't inherit the phase of the parallel region, so their phases are dropped within chunks as well.
+  if (this->previous_phase == instrument::phase::num_phases && instrument::is_tracing())
+  {
+    types::long_whole_num start_ns{static_cast<types::long_whole_num>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(this->start.time_since_epoch()).count()
+    )};
+
+    instrument::add_trace_event(phase_names[this->current_phase], "phase", start_ns, start_ns + elapsed_ns);
+  }
+
+  instrument::thread_record &record{instrument::get_thread_record()};
+  add_to(record.phase_calls[this->current_phase], 1);
+  add_to(record.phase_ns[this->current_phase], elapsed_ns);
+
+  #ifdef CA_PERF_COUNTERS
+    types::long_whole_num hw_end[instrument::hw_event::num_hw_events]{};
+
+    if (this->has_hw_counts && read_perf_group(record.perf_fd, hw_end))
+    {
+      for (types::whole_num i{}; i < instrument::hw_event::num_hw_events; i++)
+      {
+        add_to(record.phase_hw_counts[this->current_phase][i], hw_end[i] - this->hw_start[i]);
+      }
+    }
+  #endif
+}
+
+void
+instrument::reset()
+{
+  instrument::reset_allocations();
+
+  std::lock_guard<std::mutex> lock{records_mutex};
+
+  for (const auto &record : thread_records)
+  {
+    for (types::whole_num i{}; i < instrument::phase::num_phases; i++)
+    {
+      record->phase_calls[i].store(0, std::memory_order_relaxed);
+      record->phase_ns[i].store(0, std::memory_order_relaxed);
+
+      for (auto &hw_count : record->phase_hw_counts[i])
+      {
+        hw_count.store(0, std::memory_order_relaxed);
+      }
+    }
+
+    for (types::whole_num i{}; i < instrument::counter::num_counters; i++)
+    {
+      record->counters[i].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+struct phase_summary
+{
+  types::long_whole_num num_threads{};
+  types::long_whole_num num_calls{};
+  types::long_whole_num total_ns{};
+  types::long_whole_num hw_counts[instrument::hw_event::num_hw_events]{};
+};
+
+static void
+add_record(phase_summary &summary, const instrument::thread_record &record, types::whole_num phase)
+{
+  types::long_whole_num num_calls{record.phase_calls[phase].load(std::memory_order_relaxed)};
+
+  summary.num_threads += num_calls > 0;
+  summary.num_calls += num_calls;
+  summary.total_ns += record.phase_ns[phase].load(std::memory_order_relaxed);
+
+  for (types::whole_num i{}; i < instrument::hw_event::num_hw_events; i++)
+  {
+    summary.hw_counts[i] += record.phase_hw_counts[phase][i].load(std::memory_order_relaxed);
+  }
+}
+
+static void
+print_summary(std::FILE *file, const std::string &name, const phase_summary &summary, bool has_hw_counts)
+{
+  std::fprintf(
+    file,
+    "%-30s %8lu %12lu %14.3f %12.3f",
+    name.c_str(),
+    summary.num_threads,
+    summary.num_calls,
+    summary.total_ns / 1e6,
+    summary.total_ns / 1e3 / summary.num_calls
+  );
+
+  #ifdef CA_PERF_COUNTERS
+    if (has_hw_counts)
+    {
+      types::long_whole_num num_cycles{summary.hw_counts[instrument::hw_event::cycles]};
+      types::long_whole_num num_instructions{summary.hw_counts[instrument::hw_event::instructions]};
+
+      for (const auto &hw_count : summary.hw_counts)
+      {
+        std::fprintf(file, " %15lu", hw_count);
+      }
+
+      std::fprintf(file, " %6.2f", num_cycles ? static_cast<double>(num_instructions) / num_cycles : 0.0);
+    }
+    else
+    {
+      for (types::whole_num i{}; i <= instrument::hw_event::num_hw_events; i++)
+      {
+        std::fprintf(file, " %*s", i < instrument::hw_event::num_hw_events ? 15 : 6, "n/a");
+      }
+    }
+  #endif
+
+  std::fprintf(file, "\n");
+}
+
+// Phases are reported with the no. of threads that ran them, as the total time of a parallel phase is summed over its threads.
+// With hardware counters, every phase is followed by a breakdown over the threads that ran it, numbered in the order they first recorded.
+void
+instrument::report(std::FILE *file)
+{
+  if (!instrument::is_enabled)
+  {
+    std::fprintf(file, "Instrumentation is disabled, rebuild with `make clean && make INSTRUMENT=1` to enable it\n");
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock{records_mutex};
+
+  bool has_hw_counts{};
+  bool show_hw_counts{};
+
+  for (const auto &record : thread_records)
+  {
+    has_hw_counts = has_hw_counts || record->perf_fd >= 0;
+  }
+
+  #ifdef CA_PERF_COUNTERS
+    show_hw_counts = true;
+
+    if (!has_hw_counts)
+    {
+      std::fprintf(file, "\nHardware counters unavailable: %s\n", perf_error.empty() ? "no thread recorded" : perf_error.c_str());
+    }
+  #endif
+
+  std::fprintf(file, "\n%-30s %8s %12s %14s %12s", "Phase", "Threads", "Calls", "Total (ms)", "Mean (us)");
+
+  for (types::whole_num i{}; show_hw_counts && i < instrument::hw_event::num_hw_events; i++)
+  {
+    std::fprintf(file, " %15s", hw_event_names[i]);
+  }
+
+  std::fprintf(file, show_hw_counts ? " %6s\n" : "\n", "IPC");
+
+  for (types::whole_num i{}; i < instrument::phase::num_phases; i++)
+  {
+    phase_summary summary{};
+
+    for (const auto &record : thread_records)
+    {
+      add_record(summary, *record, i);
+    }
+
+    if (summary.num_calls == 0)
+    {
+      continue;
+    }
+
+    print_summary(file, phase_names[i], summary, has_hw_counts);
+
+    for (types::whole_num j{}; show_hw_counts && summary.num_threads > 1 && j < thread_records.size(); j++)
+    {
+      phase_summary thread_summary{};
+      add_record(thread_summary, *thread_records.at(j), i);
+
+      if (thread_summary.num_calls > 0)
+      {
+        print_summary(file, "  thread " + std::to_string(j), thread_summary, thread_records.at(j)->perf_fd >= 0);
+      }
+    }
+  }
+
+  std::fprintf(file, "\n%-30s %21s\n", "Counter", "Value");
+
+  for (types::whole_num i{}; i < instrument::counter::num_counters; i++)
+  {
+    types::long_whole_num value{};
+
+    for (const auto &record : thread_records)
+    {
+      value += record->counters[i].load(std::memory_order_relaxed);
+    }
+
+    std::fprintf(file, "%-30s %21lu\n", counter_names[i], value);
+  }
+
+  instrument::report_allocations(file);
+  std::fflush(file);
+}
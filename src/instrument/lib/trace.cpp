@@ -0,0 +1,270 @@
+#include "../instrument.hpp"
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct trace_event
+{
+  const char *name{};
+  const char *category{};
+  types::long_whole_num start{};
+  types::long_whole_num end{};
+  types::long_whole_num first_index{};
+  types::long_whole_num last_index{};
+  types::long_whole_num num_runs{1};
+};
+
+struct trace_buffer
+{
+  types::whole_num thread_id{};
+  std::vector<trace_event> events{};
+  types::long_whole_num num_dropped{};
+
+  // Positions of the last chunk and the last phase in `events`, which the next ones may be merged into.
+  types::long_whole_num last_chunk{};
+  types::long_whole_num last_phase{};
+  bool has_last_chunk{};
+  bool has_last_phase{};
+};
+
+static const char *chunk_category{"chunk"};
+
+// Phases that run back to back within this gap are merged, as some of them, like the output, run once per row.
+static const types::long_whole_num max_phase_gap_ns{10000};
+
+// Beyond this, the events of a thread are counted as dropped, to bound the memory of long runs.
+static const types::long_whole_num max_events_per_thread{1UL << 20};
+
+// Buffers outlive their threads, so that the events of threads that have exited are still written out.
+static std::mutex buffers_mutex{};
+static std::vector<std::unique_ptr<trace_buffer>> trace_buffers{};
+static std::atomic<bool> is_tracing_enabled{};
+static types::long_whole_num trace_origin{};
+
+// Phases are traced only outside of chunks, as the phases within a chunk can run once per permutation.
+static thread_local types::whole_num chunk_depth{};
+
+static trace_buffer &
+get_trace_buffer()
+{
+  static thread_local trace_buffer *buffer{};
+
+  if (buffer == nullptr)
+  {
+    std::lock_guard<std::mutex> lock{buffers_mutex};
+    trace_buffers.push_back(std::make_unique<trace_buffer>());
+    buffer = trace_buffers.back().get();
+    buffer->thread_id = trace_buffers.size() - 1;
+  }
+
+  return *buffer;
+}
+
+types::long_whole_num
+instrument::get_trace_time()
+{
+  return static_cast<types::long_whole_num>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()
+  );
+}
+
+bool
+instrument::is_tracing()
+{
+  return is_tracing_enabled.load(std::memory_order_relaxed);
+}
+
+void
+instrument::add_trace_event(
+  const char *name,
+  const char *category,
+  types::long_whole_num start,
+  types::long_whole_num end,
+  types::long_whole_num first_index,
+  types::long_whole_num last_index
+)
+{
+  if (!instrument::is_tracing())
+  {
+    return;
+  }
+
+  bool is_phase{std::strcmp(category, "phase") == 0};
+
+  if (is_phase && chunk_depth > 0)
+  {
+    return;
+  }
+
+  trace_buffer &buffer{get_trace_buffer()};
+
+  if (is_phase && buffer.has_last_phase)
+  {
+    trace_event &last_phase{buffer.events.at(buffer.last_phase)};
+
+    if (std::strcmp(last_phase.name, name) == 0 && start >= last_phase.end && start - last_phase.end <= max_phase_gap_ns)
+    {
+      last_phase.end = end;
+      last_phase.num_runs += 1;
+      return;
+    }
+  }
+
+  if (category == chunk_category && buffer.has_last_chunk)
+  {
+    trace_event &last_chunk{buffer.events.at(buffer.last_chunk)};
+
+    if (last_chunk.name == name && last_chunk.last_index + 1 == first_index)
+    {
+      last_chunk.end = end;
+      last_chunk.last_index = last_index;
+      return;
+    }
+  }
+
+  if (buffer.events.size() >= max_events_per_thread)
+  {
+    buffer.num_dropped += 1;
+    return;
+  }
+
+  if (category == chunk_category)
+  {
+    buffer.last_chunk = buffer.events.size();
+    buffer.has_last_chunk = true;
+  }
+
+  if (is_phase)
+  {
+    buffer.last_phase = buffer.events.size();
+    buffer.has_last_phase = true;
+  }
+
+  buffer.events.push_back({name, category, start, end, first_index, last_index});
+}
+
+instrument::trace_chunk::trace_chunk(const char *name, types::long_whole_num index)
+{
+  this->name = name;
+  this->index = index;
+  this->start = instrument::is_tracing() ? instrument::get_trace_time() : 0;
+  chunk_depth += 1;
+}
+
+instrument::trace_chunk::~trace_chunk()
+{
+  chunk_depth -= 1;
+
+  if (instrument::is_tracing())
+  {
+    instrument::add_trace_event(this->name, chunk_category, this->start, instrument::get_trace_time(), this->index, this->index);
+  }
+}
+
+instrument::trace_lock::trace_lock(const char *name, types::long_whole_num request_time)
+{
+  this->name = name;
+  this->start = instrument::is_tracing() ? instrument::get_trace_time() : 0;
+  instrument::add_trace_event(this->name, "lock_wait", request_time, this->start);
+}
+
+instrument::trace_lock::~trace_lock()
+{
+  if (instrument::is_tracing())
+  {
+    instrument::add_trace_event(this->name, "lock_hold", this->start, instrument::get_trace_time());
+  }
+}
+
+// Must be called outside of parallel regions, as the buffers of other threads are cleared.
+// The calling thread is registered first, so that it gets the first track.
+void
+instrument::start_trace()
+{
+  get_trace_buffer();
+  std::lock_guard<std::mutex> lock{buffers_mutex};
+
+  for (const auto &buffer : trace_buffers)
+  {
+    buffer->events.clear();
+    buffer->num_dropped = 0;
+    buffer->has_last_chunk = false;
+    buffer->has_last_phase = false;
+  }
+
+  trace_origin = instrument::get_trace_time();
+  is_tracing_enabled.store(true, std::memory_order_relaxed);
+}
+
+void
+instrument::stop_trace()
+{
+  is_tracing_enabled.store(false, std::memory_order_relaxed);
+}
+
+// Timestamps are written in microseconds since the start of the trace, as the format expects.
+// Every thread gets a track of its own, numbered in the order the threads first recorded an event.
+void
+instrument::write_trace(std::FILE *file)
+{
+  std::lock_guard<std::mutex> lock{buffers_mutex};
+  types::long_whole_num num_dropped{};
+  bool is_first{true};
+
+  std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+  for (const auto &buffer : trace_buffers)
+  {
+    num_dropped += buffer->num_dropped;
+
+    if (buffer->events.empty())
+    {
+      continue;
+    }
+
+    std::string thread_name{buffer->thread_id == 0 ? "main" : "thread " + std::to_string(buffer->thread_id)};
+
+    std::fprintf(
+      file,
+      "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+      is_first ? "" : ",",
+      buffer->thread_id,
+      thread_name.c_str()
+    );
+
+    is_first = false;
+
+    for (const auto &event : buffer->events)
+    {
+      types::long_whole_num start{event.start > trace_origin ? event.start - trace_origin : 0};
+      types::long_whole_num end{event.end > trace_origin ? event.end - trace_origin : 0};
+
+      std::fprintf(
+        file,
+        ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+        event.name,
+        event.category,
+        buffer->thread_id,
+        start / 1e3,
+        (end - start) / 1e3
+      );
+
+      if (std::strcmp(event.category, chunk_category) == 0)
+      {
+        std::fprintf(file, ",\"args\":{\"first\":%lu,\"last\":%lu}", event.first_index, event.last_index);
+      }
+      else if (event.num_runs > 1)
+      {
+        std::fprintf(file, ",\"args\":{\"runs\":%lu}", event.num_runs);
+      }
+
+      std::fprintf(file, "}");
+    }
+  }
+
+  std::fprintf(file, "\n],\"otherData\":{\"dropped_events\":%lu}}\n", num_dropped);
+  std::fflush(file);
+}
@@ -6,7 +6,10 @@
 
 #include <iostream>
 
+#include "cli/cli.hpp"
+#include "instrument/instrument.hpp"
 #include "models/binary-1d-ca-manager/binary-1d-ca-manager.hpp"
+#include "output/output.hpp"
 #include "types/types.hpp"
 #include "utils/utils.hpp"
 
@@ -28,6 +31,8 @@ class controller
         "Print random single cycle reversible ECAs",
         "Print random reversible ECAs",
         "Feed CA details manually",
+        "Set random seed",
+        "Print instrumentation report",
         "Exit"
       };
 
@@ -63,6 +68,15 @@ class controller
               this->ca_manager.access_system();
               break;
 
+            case 7:
+              utils::random::seed(models::binary_1d_ca_manager::read_seed());
+              break;
+
+            case 8:
+              output::flush();
+              instrument::report(stdout);
+              break;
+
             default:
               run_system = false;
               std::cout << "\n";
@@ -77,9 +91,15 @@ class controller
 };
 
 int
-main()
+main(int argc, char **argv)
 {
   utils::general::initialize();
+
+  if (argc > 1)
+  {
+    return cli::run(argc, argv);
+  }
+
   controller{}.run();
   return 0;
 }
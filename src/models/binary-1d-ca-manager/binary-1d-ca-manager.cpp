@@ -1,13 +1,165 @@
 #include "binary-1d-ca-manager.hpp"
 
+#include <omp.h>
+
 #include <iostream>
+#include <map>
+#include <set>
+#include <stdexcept>
 #include <unordered_set>
 #include <vector>
 
+#include "../../instrument/instrument.hpp"
 #include "../../terminal/terminal.hpp"
 #include "../../utils/utils.hpp"
 #include "../reversible-eca/reversible-eca.hpp"
 
+struct rpi_result
+{
+  bool has_trivial_partition{};
+  bool has_non_trivial_partitions{};
+  bool has_1_1_or_1_n_sn_maps{};
+};
+
+static void
+validate_survey_size(types::short_whole_num num_cells)
+{
+  if (num_cells < 3)
+  {
+    throw std::invalid_argument{"Minimum size of ECA should be 3"};
+  }
+
+  if (num_cells > models::binary_1d_ca::max_size)
+  {
+    throw std::invalid_argument{"Unsupported cellular automata size"};
+  }
+}
+
+// This is the batch driver behind the survey commands.
+// It works in three phases:
+//   1. Rule vectors are generated in parallel, with sample i drawing from random stream i.
+//   2. Repeated rule vectors are dropped, keeping the first occurrence of each.
+//   3. The remaining rule vectors are analysed in parallel.
+//
+// The analyser returns whether a rule vector should be reported, and fills in its result.
+// Rows are returned in sample order, so the output depends only on the seed and the sample count, and not on the thread count.
+template <typename result_type, typename generator_type, typename analyser_type>
+static std::vector<std::pair<types::rules, result_type>>
+run_survey(
+  types::long_whole_num num_samples,
+  const generator_type &generate,
+  const analyser_type &analyse
+)
+{
+  std::vector<types::rules> samples(num_samples);
+
+  #pragma omp parallel for schedule(static)
+  for (types::long_whole_num i = 0; i < num_samples; i++)
+  {
+    CA_SCOPED_TIMER(survey_generate);
+    utils::random::select_stream(i);
+    samples.at(i) = generate(i);
+  }
+
+  std::set<types::rules> seen_samples{};
+  std::vector<types::rules> unique_samples{};
+
+  for (auto &sample : samples)
+  {
+    if (seen_samples.insert(sample).second)
+    {
+      unique_samples.push_back(std::move(sample));
+    }
+  }
+
+  std::vector<result_type> results(unique_samples.size());
+  std::vector<char> is_selected(unique_samples.size(), 0);
+
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (types::long_whole_num i = 0; i < unique_samples.size(); i++)
+  {
+    CA_SCOPED_TIMER(survey_analyse);
+    result_type result{};
+    is_selected.at(i) = analyse(unique_samples.at(i), result);
+    results.at(i) = result;
+  }
+
+  std::vector<std::pair<types::rules, result_type>> rows{};
+
+  for (types::long_whole_num i{}; i < unique_samples.size(); i++)
+  {
+    if (is_selected.at(i))
+    {
+      rows.emplace_back(std::move(unique_samples.at(i)), results.at(i));
+    }
+  }
+
+  return rows;
+}
+
+// Rows of class representatives are expanded to every rule of their classes, in the order of the rules.
+template <typename result_type>
+static std::vector<std::pair<types::rules, result_type>>
+expand_uniform_rows(
+  const std::vector<std::pair<types::rules, result_type>> &representative_rows,
+  types::short_whole_num num_cells,
+  types::boundary boundary
+)
+{
+  std::map<types::long_whole_num, result_type> representative_results{};
+
+  for (const auto &row : representative_rows)
+  {
+    representative_results.emplace(row.first.at(0), row.second);
+  }
+
+  std::vector<std::pair<types::rules, result_type>> rows{};
+
+  for (types::long_whole_num rule{}; rule < 256; rule++)
+  {
+    auto representative_result{representative_results.find(utils::eca_symmetry::get_representative(rule, boundary))};
+
+    if (representative_result != representative_results.end())
+    {
+      rows.emplace_back(types::rules(num_cells, rule), representative_result->second);
+    }
+  }
+
+  return rows;
+}
+
+template <typename result_type>
+static void
+print_rules_rows(
+  const std::vector<std::pair<types::rules, result_type>> &rows,
+  types::short_whole_num num_cells
+)
+{
+  types::long_whole_num counter{};
+
+  std::vector<std::pair<std::string, types::short_whole_num>> headings{
+    std::make_pair<std::string, types::short_whole_num>("S. No", 7),
+    std::make_pair<std::string, types::short_whole_num>("Rules", std::max(num_cells * 6, 24))
+  };
+
+  utils::general::print_header(headings, {output::field_type::number, output::field_type::number_list});
+
+  for (const auto &row : rows)
+  {
+    std::vector<std::pair<std::string, types::short_whole_num>> entries{
+      std::make_pair<std::string, types::short_whole_num>(
+        std::to_string(++counter), 7
+      ),
+      std::make_pair<std::string, types::short_whole_num>(
+        utils::vector::to_string<types::long_whole_num>(row.first),
+        std::max(num_cells * 6, 24)
+      )
+    };
+
+    utils::general::print_row(entries);
+  }
+}
+
 types::short_whole_num
 models::binary_1d_ca_manager::read_num_cells()
 {
@@ -65,156 +217,134 @@ models::binary_1d_ca_manager::read_rules(types::short_whole_num num_rules)
   return rules;
 }
 
-void
-models::binary_1d_ca_manager::print_reversed_pseudo_isomorphable_ecas(bool is_uniform)
+types::long_whole_num
+models::binary_1d_ca_manager::read_seed()
 {
-  types::short_whole_num counter{};
-  types::short_whole_num num_cells{models::binary_1d_ca_manager::read_num_cells()};
-  types::boundary boundary{models::binary_1d_ca_manager::read_boundary()};
-
-  bool header_printed{};
-  bool has_trivial_partition{};
-  bool has_non_trivial_partitions{};
-  models::binary_1d_ca current_ca{};
-
-  std::vector<std::pair<std::string, types::short_whole_num>> headings{
-    std::make_pair<std::string, types::short_whole_num>("S. No", 7),
-    std::make_pair<std::string, types::short_whole_num>("Rules", std::max(num_cells * 6, 24)),
-    std::make_pair<std::string, types::short_whole_num>("Trivial Partition", 17),
-    std::make_pair<std::string, types::short_whole_num>("Non Trivial Partitions", 22),
-    std::make_pair<std::string, types::short_whole_num>("1-1/1-N SN Maps", 15)
-  };
-
-  types::short_whole_num n = is_uniform ? 256 : 1000;
-
-  for (types::short_whole_num i{}; i < n; i++)
-  {
-    has_trivial_partition = false;
-    has_non_trivial_partitions = false;
+  types::long_whole_num seed{};
+  std::cout << "\n";
 
-    if (is_uniform)
-    {
-      types::rules rules(num_cells, i);
-      current_ca = models::binary_1d_ca{num_cells, 1, 1, boundary, rules};
-    }
-    else
-    {
-      current_ca = models::reversible_eca::get_random(num_cells, boundary);
-    }
+  std::cout << "Random seed (current: " << utils::random::get_seed() << "): ";
+  std::cin >> seed;
 
-    if (
-      current_ca.has_non_trivial_reversed_pseudo_isomorphisms(
-        has_trivial_partition, has_non_trivial_partitions
-      )
-    )
-    {
-      if (!header_printed)
-      {
-        utils::general::print_header(headings);
-        header_printed = true;
-      }
+  return seed;
+}
 
-      std::vector<std::pair<std::string, types::short_whole_num>> entries{
-        std::make_pair<std::string, types::short_whole_num>(
-          std::to_string(++counter), 7
-        ),
-        std::make_pair<std::string, types::short_whole_num>(
-          current_ca.get_rule_vector().to_string(),
-          std::max(num_cells * 6, 24)
-        ),
-        std::make_pair<std::string, types::short_whole_num>(
-          has_trivial_partition ? "True" : "False", 17
-        ),
-        std::make_pair<std::string, types::short_whole_num>(
-          has_non_trivial_partitions ? "True" : "False", 22
-        ),
-        std::make_pair<std::string, types::short_whole_num>(
-          current_ca.has_1_1_or_1_n_sn_maps() ? "True" : "False", 15
-        )
-      };
+types::long_whole_num
+models::binary_1d_ca_manager::read_num_samples()
+{
+  types::long_whole_num num_samples{};
+  std::cout << "\n";
 
-      utils::general::print_row(entries);
-    }
-  }
+  std::cout << "No. of samples: ";
+  std::cin >> num_samples;
 
-  if (!header_printed)
-  {
-    utils::general::print_msg("Couldn't generate any required ECAs", colors::blue);
-  }
+  return num_samples;
 }
 
 void
-models::binary_1d_ca_manager::print_single_cycle_reversible_ecas()
+models::binary_1d_ca_manager::print_reversed_pseudo_isomorphable_ecas(bool is_uniform)
 {
-  types::short_whole_num counter{};
   types::short_whole_num num_cells{models::binary_1d_ca_manager::read_num_cells()};
   types::boundary boundary{models::binary_1d_ca_manager::read_boundary()};
+  types::long_whole_num num_samples{is_uniform ? 0 : models::binary_1d_ca_manager::read_num_samples()};
 
-  bool header_printed{};
-  models::binary_1d_ca current_ca{};
+  models::binary_1d_ca_manager::print_reversed_pseudo_isomorphable_ecas(
+    num_cells, boundary, is_uniform, num_samples
+  );
+}
 
-  std::vector<std::pair<std::string, types::short_whole_num>> headings{
-    std::make_pair<std::string, types::short_whole_num>("S. No", 7),
-    std::make_pair<std::string, types::short_whole_num>("Rules", std::max(num_cells * 6, 24))
+void
+models::binary_1d_ca_manager::print_reversed_pseudo_isomorphable_ecas(
+  types::short_whole_num num_cells,
+  types::boundary boundary,
+  bool is_uniform,
+  types::long_whole_num num_samples
+)
+{
+  validate_survey_size(num_cells);
+
+  // Uniform rules related by reflection or conjugation have isomorphic transition graphs, and so the same results.
+  // So only one rule of every class is analysed, and its result is shared by the rest of the class.
+  std::vector<types::long_whole_num> representatives{
+    is_uniform ? utils::eca_symmetry::get_representatives(boundary) : std::vector<types::long_whole_num>{}
   };
 
-  for (types::short_whole_num i{}; i < 1000; i++)
-  {
-    current_ca = models::reversible_eca::get_random(num_cells, boundary);
+  std::vector<std::pair<types::rules, rpi_result>> rows{
+    run_survey<rpi_result>(
+      is_uniform ? representatives.size() : num_samples,
+      [num_cells, boundary, is_uniform, &representatives](types::long_whole_num index) {
+        if (is_uniform)
+        {
+          return types::rules(num_cells, representatives.at(index));
+        }
 
-    if (utils::transition_graph::get_cycles(current_ca.get_graph()).size() <= 1)
-    {
-      if (!header_printed)
-      {
-        utils::general::print_header(headings);
-        header_printed = true;
-      }
+        return models::reversible_eca::get_random_rules(num_cells, boundary);
+      },
+      [num_cells, boundary](const types::rules &rules, rpi_result &result) {
+        models::binary_1d_ca current_ca{num_cells, 1, 1, boundary, rules};
 
-      std::vector<std::pair<std::string, types::short_whole_num>> entries{
-        std::make_pair<std::string, types::short_whole_num>(
-          std::to_string(++counter), 7
-        ),
-        std::make_pair<std::string, types::short_whole_num>(
-          current_ca.get_rule_vector().to_string(), std::max(num_cells * 6, 24)
+        if (
+          !current_ca.has_non_trivial_reversed_pseudo_isomorphisms(
+            result.has_trivial_partition, result.has_non_trivial_partitions
+          )
         )
-      };
+        {
+          return false;
+        }
 
-      utils::general::print_row(entries);
-    }
+        result.has_1_1_or_1_n_sn_maps = current_ca.has_1_1_or_1_n_sn_maps();
+        return true;
+      }
+    )
+  };
+
+  if (is_uniform)
+  {
+    rows = expand_uniform_rows(rows, num_cells, boundary);
   }
 
-  if (!header_printed)
+  if (rows.empty())
   {
     utils::general::print_msg("Couldn't generate any required ECAs", colors::blue);
+    return;
   }
-}
 
-void
-models::binary_1d_ca_manager::print_reversible_ecas()
-{
-  types::short_whole_num counter{};
-  types::short_whole_num num_cells{models::binary_1d_ca_manager::read_num_cells()};
-  types::boundary boundary{models::binary_1d_ca_manager::read_boundary()};
-  models::binary_1d_ca current_ca{};
+  types::long_whole_num counter{};
 
   std::vector<std::pair<std::string, types::short_whole_num>> headings{
     std::make_pair<std::string, types::short_whole_num>("S. No", 7),
-    std::make_pair<std::string, types::short_whole_num>("Rules", std::max(num_cells * 6, 24))
+    std::make_pair<std::string, types::short_whole_num>("Rules", std::max(num_cells * 6, 24)),
+    std::make_pair<std::string, types::short_whole_num>("Trivial Partition", 17),
+    std::make_pair<std::string, types::short_whole_num>("Non Trivial Partitions", 22),
+    std::make_pair<std::string, types::short_whole_num>("1-1/1-N SN Maps", 15)
   };
 
-  utils::general::print_header(headings);
+  utils::general::print_header(headings, {
+    output::field_type::number,
+    output::field_type::number_list,
+    output::field_type::boolean,
+    output::field_type::boolean,
+    output::field_type::boolean
+  });
 
-  for (types::short_whole_num i{}; i < 100; i++)
+  for (const auto &row : rows)
   {
-    current_ca = models::reversible_eca::get_random(num_cells, boundary);
-
     std::vector<std::pair<std::string, types::short_whole_num>> entries{
       std::make_pair<std::string, types::short_whole_num>(
         std::to_string(++counter), 7
       ),
       std::make_pair<std::string, types::short_whole_num>(
-        current_ca.get_rule_vector().to_string(),
+        utils::vector::to_string<types::long_whole_num>(row.first),
         std::max(num_cells * 6, 24)
+      ),
+      std::make_pair<std::string, types::short_whole_num>(
+        row.second.has_trivial_partition ? "True" : "False", 17
+      ),
+      std::make_pair<std::string, types::short_whole_num>(
+        row.second.has_non_trivial_partitions ? "True" : "False", 22
+      ),
+      std::make_pair<std::string, types::short_whole_num>(
+        row.second.has_1_1_or_1_n_sn_maps ? "True" : "False", 15
       )
     };
 
@@ -222,6 +352,81 @@ models::binary_1d_ca_manager::print_reversible_ecas()
   }
 }
 
+void
+models::binary_1d_ca_manager::print_single_cycle_reversible_ecas()
+{
+  types::short_whole_num num_cells{models::binary_1d_ca_manager::read_num_cells()};
+  types::boundary boundary{models::binary_1d_ca_manager::read_boundary()};
+  types::long_whole_num num_samples{models::binary_1d_ca_manager::read_num_samples()};
+
+  models::binary_1d_ca_manager::print_single_cycle_reversible_ecas(num_cells, boundary, num_samples);
+}
+
+void
+models::binary_1d_ca_manager::print_single_cycle_reversible_ecas(
+  types::short_whole_num num_cells,
+  types::boundary boundary,
+  types::long_whole_num num_samples
+)
+{
+  validate_survey_size(num_cells);
+
+  std::vector<std::pair<types::rules, bool>> rows{
+    run_survey<bool>(
+      num_samples,
+      [num_cells, boundary](types::long_whole_num) {
+        return models::reversible_eca::get_random_rules(num_cells, boundary);
+      },
+      [num_cells, boundary](const types::rules &rules, bool &) {
+        models::binary_1d_ca current_ca{num_cells, 1, 1, boundary, rules};
+        return utils::transition_graph::get_cycles(current_ca.get_graph()).size() <= 1;
+      }
+    )
+  };
+
+  if (rows.empty())
+  {
+    utils::general::print_msg("Couldn't generate any required ECAs", colors::blue);
+    return;
+  }
+
+  print_rules_rows(rows, num_cells);
+}
+
+void
+models::binary_1d_ca_manager::print_reversible_ecas()
+{
+  types::short_whole_num num_cells{models::binary_1d_ca_manager::read_num_cells()};
+  types::boundary boundary{models::binary_1d_ca_manager::read_boundary()};
+  types::long_whole_num num_samples{models::binary_1d_ca_manager::read_num_samples()};
+
+  models::binary_1d_ca_manager::print_reversible_ecas(num_cells, boundary, num_samples);
+}
+
+void
+models::binary_1d_ca_manager::print_reversible_ecas(
+  types::short_whole_num num_cells,
+  types::boundary boundary,
+  types::long_whole_num num_samples
+)
+{
+  validate_survey_size(num_cells);
+
+  std::vector<std::pair<types::rules, bool>> rows{
+    run_survey<bool>(
+      num_samples,
+      [num_cells, boundary](types::long_whole_num) {
+        return models::reversible_eca::get_random_rules(num_cells, boundary);
+      },
+      [](const types::rules &, bool &) {
+        return true;
+      }
+    )
+  };
+
+  print_rules_rows(rows, num_cells);
+}
+
 void
 models::binary_1d_ca_manager::read_ca_details()
 {
@@ -258,6 +463,7 @@ models::binary_1d_ca_manager::access_system()
     "Print CAs by complementing rules based on equivalent RMTs",
     "Print affected configurations by tweaking rules",
     "Print state-neighborhood maps",
+    "Jump ahead",
     "Go back"
   };
 
@@ -265,81 +471,111 @@ models::binary_1d_ca_manager::access_system()
   {
     types::short_whole_num choice{utils::general::get_choice(choices)};
 
-    switch (choice)
+    try
     {
-      case 1: {
-        this->current_ca.print_transition_graph();
-        break;
-      }
+      switch (choice)
+      {
+        case 1: {
+          this->current_ca.print_transition_graph();
+          break;
+        }
 
-      case 2: {
-        this->current_ca.print_details();
-        break;
-      }
+        case 2: {
+          this->current_ca.print_details();
+          break;
+        }
 
-      case 3: {
-        this->current_ca.print_isomorphisms();
-        break;
-      }
+        case 3: {
+          this->current_ca.print_isomorphisms();
+          break;
+        }
 
-      case 4: {
-        types::short_whole_num num_cells{this->current_ca.get_num_cells()};
-        types::short_whole_num l_radius{this->current_ca.get_l_radius()};
-        types::short_whole_num r_radius{this->current_ca.get_r_radius()};
-        types::boundary boundary{this->current_ca.get_boundary()};
-        types::rules rules{read_rules(num_cells)};
-        models::binary_1d_ca other{num_cells, l_radius, r_radius, boundary, rules};
+        case 4: {
+          types::short_whole_num num_cells{this->current_ca.get_num_cells()};
+          types::short_whole_num l_radius{this->current_ca.get_l_radius()};
+          types::short_whole_num r_radius{this->current_ca.get_r_radius()};
+          types::boundary boundary{this->current_ca.get_boundary()};
+          types::rules rules{read_rules(num_cells)};
+          models::binary_1d_ca other{num_cells, l_radius, r_radius, boundary, rules};
+
+          if (this->current_ca.is_isomorphic(other))
+          {
+            utils::general::print_msg("Isomorphic", colors::cyan);
+          }
+          else
+          {
+            utils::general::print_msg("Not isomorphic", colors::blue);
+          }
+
+          break;
+        }
 
-        if (this->current_ca.is_isomorphic(other))
-        {
-          utils::general::print_msg("Isomorphic", colors::cyan);
+        case 5: {
+          this->current_ca.print_complemented_isomorphisms();
+          break;
         }
-        else
-        {
-          utils::general::print_msg("Not isomorphic", colors::blue);
+
+        case 6: {
+          this->current_ca.print_reversed_pseudo_isomorphisms();
+          break;
         }
 
-        break;
-      }
+        case 7: {
+          this->current_ca.print_characterisitc_matrix();
+          break;
+        }
 
-      case 5: {
-        this->current_ca.print_complemented_isomorphisms();
-        break;
-      }
+        case 8: {
+          this->current_ca.print_characterisitc_polynomial();
+          break;
+        }
 
-      case 6: {
-        this->current_ca.print_reversed_pseudo_isomorphisms();
-        break;
-      }
+        case 9: {
+          this->current_ca.print_rmts_complemented_rules();
+          break;
+        }
 
-      case 7: {
-        this->current_ca.print_characterisitc_matrix();
-        break;
-      }
+        case 10: {
+          this->current_ca.tweak_rules();
+          break;
+        }
 
-      case 8: {
-        this->current_ca.print_characterisitc_polynomial();
-        break;
-      }
+        case 11: {
+          this->current_ca.print_sn_maps();
+          break;
+        }
 
-      case 9: {
-        this->current_ca.print_rmts_complemented_rules();
-        break;
-      }
+        case 12: {
+          std::string config_str{};
+          types::long_whole_num steps{};
 
-      case 10: {
-        this->current_ca.tweak_rules();
-        break;
-      }
+          std::cout << "Configuration: ";
+          std::cin >> config_str;
 
-      case 11: {
-        this->current_ca.print_sn_maps();
-        break;
-      }
+          std::cout << "Steps: ";
+          std::cin >> steps;
+
+          if (config_str.size() != this->current_ca.get_num_cells() || config_str.find_first_not_of("01") != std::string::npos)
+          {
+            throw std::invalid_argument{"Invalid configuration"};
+          }
 
-      default: {
-        run_system = false;
+          this->current_ca.print_future_config(
+            static_cast<types::short_whole_num>(utils::number::parse_binary_str(config_str)),
+            steps
+          );
+
+          break;
+        }
+
+        default: {
+          run_system = false;
+        }
       }
     }
+    catch (const std::exception &err)
+    {
+      utils::general::print_msg(err.what(), colors::red);
+    }
   }
 }
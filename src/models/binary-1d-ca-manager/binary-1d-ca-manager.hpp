@@ -21,15 +21,43 @@ namespace models
       static types::rules
       read_rules(types::short_whole_num num_rules);
 
+      static types::long_whole_num
+      read_seed();
+
+      static types::long_whole_num
+      read_num_samples();
+
       static void
       print_reversed_pseudo_isomorphable_ecas(bool is_uniform = false);
 
+      static void
+      print_reversed_pseudo_isomorphable_ecas(
+        types::short_whole_num num_cells,
+        types::boundary boundary,
+        bool is_uniform,
+        types::long_whole_num num_samples
+      );
+
       static void
       print_single_cycle_reversible_ecas();
 
+      static void
+      print_single_cycle_reversible_ecas(
+        types::short_whole_num num_cells,
+        types::boundary boundary,
+        types::long_whole_num num_samples
+      );
+
       static void
       print_reversible_ecas();
 
+      static void
+      print_reversible_ecas(
+        types::short_whole_num num_cells,
+        types::boundary boundary,
+        types::long_whole_num num_samples
+      );
+
       void
       read_ca_details();
 
@@ -4,12 +4,19 @@
 
 #include <algorithm>
 #include <climits>
+#include <cstring>
 #include <sstream>
 #include <stdexcept>
 #include <unordered_set>
 
+#include "../../instrument/instrument.hpp"
+#include "../../output/output.hpp"
 #include "../../terminal/terminal.hpp"
 #include "../../utils/utils.hpp"
+#include "../graph-cache/graph-cache.hpp"
+#include "../orbit-index/orbit-index.hpp"
+#include "../rmt-delta-engine/rmt-delta-engine.hpp"
+#include "../result-cache/result-cache.hpp"
 
 static std::string
 get_boundary_str(types::boundary boundary)
@@ -22,6 +29,26 @@ get_boundary_str(types::boundary boundary)
   return "Periodic";
 }
 
+// Versions of the cached analyses, to be bumped whenever their results change.
+static const types::whole_num isomorphism_version{1};
+static const types::whole_num reversed_pseudo_isomorphism_version{1};
+static const types::whole_num isomorphic_complements_version{1};
+
+template <typename compute_type>
+static std::string
+get_cached_result(const std::string &key, const compute_type &compute)
+{
+  std::string value{};
+
+  if (!models::result_cache::load(key, value))
+  {
+    value = compute();
+    models::result_cache::store(key, value);
+  }
+
+  return value;
+}
+
 static void
 validate_radii(
   types::short_whole_num num_cells,
@@ -39,6 +66,11 @@ validate_radii(
     throw std::invalid_argument{"Unsupported right radius"};
   }
 
+  if (l_radius + r_radius + 1 > models::binary_1d_ca::max_num_neighbors)
+  {
+    throw std::invalid_argument{"Unsupported neighborhood size"};
+  }
+
   if (num_cells < l_radius + r_radius + 1)
   {
     throw std::invalid_argument{"Neighborhood size can't be greater than CA size"};
@@ -60,7 +92,7 @@ validate_rules(
 
   types::short_whole_num num_neighbors{static_cast<types::short_whole_num>(l_radius + r_radius + 1)};
   types::short_whole_num num_rule_min_terms{static_cast<types::short_whole_num>(1U << num_neighbors)};
-  types::long_whole_num max_rule{(1UL << num_rule_min_terms) - 1};
+  types::long_whole_num max_rule{num_rule_min_terms == 64 ? ~0UL : (1UL << num_rule_min_terms) - 1};
 
   for (const auto &rule : rules)
   {
@@ -80,50 +112,41 @@ validate_ca_size(types::short_whole_num num_cells)
   }
 }
 
-bool
-models::binary_1d_ca::is_elementary() const
+// Bit i of `cells` corresponds to cell i, while cell i is bit (n - 1 - i) of a configuration.
+static types::short_whole_num
+get_config_mask(types::long_whole_num cells, types::short_whole_num num_cells)
 {
-  return this->l_radius == 1 && this->r_radius == 1;
-}
+  types::short_whole_num mask{};
 
-bool
-models::binary_1d_ca::is_reversible() const
-{
-  types::cycles cycles{utils::transition_graph::get_cycles(this->get_graph())};
-  types::short_whole_num num_cycled_nodes{};
-
-  for (const auto &cycle : cycles)
+  for (types::short_whole_num i{}; i < num_cells; i++)
   {
-    num_cycled_nodes += cycle.size();
+    mask |= ((cells >> i) & 1) << (num_cells - 1 - i);
   }
 
-  return num_cycled_nodes == this->get_graph().size();
+  return mask;
 }
 
 bool
-models::binary_1d_ca::has_cycle_strucutre_as(const models::binary_1d_ca &other) const
+models::binary_1d_ca::is_elementary() const
 {
-  static auto by_size_asc{[](const auto &obj_1, const auto &obj_2) {
-    return obj_1.size() < obj_2.size();
-  }};
-
-  types::cycles this_cycles{utils::transition_graph::get_cycles(this->get_graph())};
-  types::cycles other_cycles{utils::transition_graph::get_cycles(other.get_graph())};
-
-  if (this_cycles.size() != other_cycles.size())
-  {
-    return false;
-  }
+  return this->l_radius == 1 && this->r_radius == 1;
+}
 
-  std::sort(this_cycles.begin(), this_cycles.end(), by_size_asc);
-  std::sort(other_cycles.begin(), other_cycles.end(), by_size_asc);
+// The graph is already built, so a CA is reversible exactly when no two configurations share a successor.
+bool
+models::binary_1d_ca::is_reversible() const
+{
+  const types::transition_graph &graph{this->get_graph()};
+  std::vector<bool> has_predecessor(graph.size());
 
-  for (types::short_whole_num i{}; i < this_cycles.size(); i++)
+  for (const auto &next_config : graph)
   {
-    if (this_cycles.at(i).size() != other_cycles.at(i).size())
+    if (has_predecessor[next_config])
     {
       return false;
     }
+
+    has_predecessor[next_config] = true;
   }
 
   return true;
@@ -148,203 +171,116 @@ models::binary_1d_ca::has_complemented_isomorphisms() const
 bool
 models::binary_1d_ca::extract_rules(const types::transition_graph &graph, types::rules &rules) const
 {
-  for (types::short_whole_num i{}; i < this->num_cells; i++)
-  {
-    std::vector<char> current_rule_row((1U << this->num_neighbors), 'X');
-    std::ostringstream current_rule_stream{};
-
-    for (types::short_whole_num j{}; j < this->num_configs; j++)
-    {
-      std::string current_config_str{utils::number::to_binary_str(j, this->num_cells)};
-      std::string next_config_str{utils::number::to_binary_str(graph.at(j), this->num_cells)};
-      std::string neighborhood_str{this->get_neighborhood_str(i, current_config_str)};
-
-      types::short_whole_num neighborhood{static_cast<types::short_whole_num>(
-        utils::number::parse_binary_str(neighborhood_str)
-      )};
-
-      char next_state{next_config_str.at(i)};
-
-      if (current_rule_row.at(neighborhood) == 'X')
-      {
-        current_rule_row.at(neighborhood) = next_state;
-      }
-      else if (current_rule_row.at(neighborhood) != next_state)
-      {
-        return false;
-      }
-    }
+  CA_SCOPED_TIMER(extract_rules);
+  CA_COUNT(extract_rules_calls, 1);
 
-    for (types::short_whole_num j{}; j < current_rule_row.size(); j++)
-    {
-      char current_char{current_rule_row.at(current_rule_row.size() - 1 - j)};
-      current_rule_stream << (current_char == 'X' ? '0' : current_char);
-    }
-
-    rules.at(i) = utils::number::parse_binary_str(current_rule_stream.str());
-  }
-
-  return true;
+  return this->kernels->extract_rules(this->num_cells, graph, rules);
 }
 
 types::short_whole_num
-models::binary_1d_ca::get_next_config(types::short_whole_num current_config)
+models::binary_1d_ca::get_next_config(types::short_whole_num current_config) const
 {
-  std::unordered_map<types::short_whole_num, types::short_whole_num> global_config_map{};
-
-  if (global_config_map.count(current_config))
-  {
-    return global_config_map.at(current_config);
-  }
+  return this->kernels->get_next_config(current_config, this->num_cells, this->rule_vector.get_rules());
+}
 
-  std::ostringstream next_config_stream{};
-  std::string current_config_str{utils::number::to_binary_str(current_config, this->num_cells)};
+void
+models::binary_1d_ca::set_rules(const types::rules &rules)
+{
+  this->cells.resize(this->num_cells);
 
   for (types::short_whole_num i{}; i < this->num_cells; i++)
   {
-    models::binary_cell &current_cell{this->cells.at(i)};
-    bool next_state{current_cell.next_state(this->get_neighborhood_str(i, current_config_str))};
-    next_config_stream << static_cast<types::short_whole_num>(next_state);
+    this->cells.at(i).set_rule(rules.at(i));
   }
-
-  types::short_whole_num next_config{static_cast<types::short_whole_num>(
-    utils::number::parse_binary_str(next_config_stream.str())
-  )};
-
-  return global_config_map[current_config] = next_config;
 }
 
-std::string
-models::binary_1d_ca::get_neighborhood_str(
-  types::short_whole_num cell_num,
-  const std::string &config_str
-) const
+void
+models::binary_1d_ca::set_config(types::short_whole_num config)
 {
-  std::ostringstream neighborhood_stream{};
-  bool has_null_boundary{this->boundary == types::boundary::null};
-
-  for (types::short_whole_num l{this->l_radius}; l >= 1; l--)
+  for (types::short_whole_num i{}; i < this->num_cells; i++)
   {
-    types::short_num current_neighbor_index{static_cast<types::short_num>((cell_num - l))};
-
-    if (current_neighbor_index < 0 && has_null_boundary)
-    {
-      neighborhood_stream << '0';
-      continue;
-    }
-
-    current_neighbor_index = (this->num_cells + current_neighbor_index) % this->num_cells;
-    neighborhood_stream << config_str.at(current_neighbor_index);
+    this->cells.at(i).set_state((config >> (this->num_cells - 1 - i)) & 1);
   }
+}
 
-  neighborhood_stream << config_str.at(cell_num);
-
-  for (types::short_whole_num r{1}; r <= this->r_radius; r++)
+void
+models::binary_1d_ca::randomize_config()
+{
+  for (auto &cell : this->cells)
   {
-    types::short_num current_neighbor_index{static_cast<types::short_num>((cell_num + r))};
-
-    if (current_neighbor_index >= this->num_cells && has_null_boundary)
-    {
-      neighborhood_stream << '0';
-      continue;
-    }
-
-    current_neighbor_index = current_neighbor_index % this->num_cells;
-    neighborhood_stream << config_str.at(current_neighbor_index);
+    cell.set_state(utils::general::get_random_bool());
   }
-
-  return neighborhood_stream.str();
 }
 
-std::unordered_set<types::short_whole_num>
-models::binary_1d_ca::get_affected_configs(
-  const models::binary_1d_ca &other,
-  types::short_whole_num &num_cycles_affected
-) const
+// Additive ECAs have an affine global map, with graph[x ^ y] == graph[x] ^ graph[y] ^ graph[0].
+// So only the images of 0 and of the n unit configurations are computed from the rules.
+// The rest are filled in Gray code order, where each configuration differs from the previous one in a single bit.
+// Other CAs step every configuration with the kernel of their shape.
+void
+models::binary_1d_ca::fill_transition_graph()
 {
-  types::cycles this_cycles{utils::transition_graph::get_cycles(this->get_graph())};
-  std::unordered_set<types::short_whole_num> affected_configs{};
-  std::vector<bool> is_cycle_affected(this_cycles.size(), false);
+  CA_SCOPED_TIMER(fill_transition_graph);
 
-  const types::transition_graph &this_graph{this->get_graph()};
-  const types::transition_graph &other_graph{other.get_graph()};
+  this->graph.resize(this->num_configs);
 
-  for (const auto &config : this_graph)
+  if (!this->is_elementary() || !this->rule_vector.is_additive())
   {
-    if (this_graph.at(config) != other_graph.at(config))
-    {
-      affected_configs.insert(config);
-    }
+    this->kernels->fill_transition_graph(this->num_cells, this->rule_vector.get_rules(), this->graph);
+    return;
   }
 
-  num_cycles_affected = 0;
+  types::short_whole_num offset{this->get_next_config(0)};
+  std::vector<types::short_whole_num> basis_images(this->num_cells);
 
-  for (const auto &config : affected_configs)
+  for (types::short_whole_num i{}; i < this->num_cells; i++)
   {
-    for (types::short_whole_num i{}; i < this_cycles.size(); i++)
-    {
-      if (this_cycles.at(i).count(config))
-      {
-        num_cycles_affected += is_cycle_affected.at(i) ? 0 : 1;
-        is_cycle_affected.at(i) = true;
-      }
-    }
+    basis_images.at(i) = this->get_next_config(1U << i) ^ offset;
   }
 
-  return affected_configs;
-}
-
-void
-models::binary_1d_ca::set_rules(const types::rules &rules)
-{
-  this->cells.resize(this->num_cells);
+  types::short_whole_num current_config{};
+  this->graph.at(current_config) = offset;
 
-  for (types::short_whole_num i{}; i < this->num_cells; i++)
+  for (types::whole_num i{1}; i < this->num_configs; i++)
   {
-    this->cells.at(i).set_rule(rules.at(i));
-  }
-}
+    types::short_whole_num flipped_bit{static_cast<types::short_whole_num>(__builtin_ctz(i))};
+    types::short_whole_num next_config{static_cast<types::short_whole_num>(current_config ^ (1U << flipped_bit))};
 
-void
-models::binary_1d_ca::randomize_config()
-{
-  for (auto &cell : this->cells)
-  {
-    cell.set_state(utils::general::get_random_bool());
+    this->graph[next_config] = this->graph[current_config] ^ basis_images[flipped_bit];
+    current_config = next_config;
   }
 }
 
 void
-models::binary_1d_ca::fill_transition_graph()
+models::binary_1d_ca::fill_sn_maps()
 {
-  this->graph.resize(this->num_configs);
+  CA_SCOPED_TIMER(fill_sn_maps);
 
-  for (types::short_whole_num i{}; i < this->num_configs; i++)
-  {
-    this->graph.at(i) = this->get_next_config(i);
-  }
+  this->kernels->fill_sn_maps(this->num_cells, this->graph, this->sn_maps);
 }
 
+// The graph is read from the cache when it holds one for these parameters, and is built and stored otherwise.
 void
-models::binary_1d_ca::fill_sn_maps()
+models::binary_1d_ca::load_transition_graph()
 {
-  this->sn_maps.resize(this->num_cells);
+  types::rules rules{this->rule_vector.get_rules()};
+  std::unique_ptr<models::mapped_graph> cached_graph{
+    models::graph_cache::map(this->num_cells, this->l_radius, this->r_radius, this->boundary, rules)
+  };
 
-  for (types::short_whole_num i{}; i < this->num_cells; i++)
+  if (cached_graph != nullptr)
   {
-    this->sn_maps.at(i).insert(std::make_pair<char, std::unordered_set<std::string>>('0', {}));
-    this->sn_maps.at(i).insert(std::make_pair<char, std::unordered_set<std::string>>('1', {}));
+    this->graph.resize(this->num_configs);
+    std::memcpy(this->graph.data(), cached_graph->get_successors(), this->num_configs * sizeof(types::short_whole_num));
+    return;
   }
 
-  for (const auto &config : this->graph)
-  {
-    std::string config_str{utils::number::to_binary_str(config, this->num_cells)};
-    std::string next_config_str{utils::number::to_binary_str(this->graph.at(config), this->num_cells)};
+  this->fill_transition_graph();
 
-    for (types::short_whole_num i{}; i < this->num_cells; i++)
-    {
-      this->sn_maps.at(i).at(config_str.at(i)).insert(this->get_neighborhood_str(i, next_config_str));
-    }
+  if (models::graph_cache::is_enabled())
+  {
+    models::graph_cache::store(
+      this->num_cells, this->l_radius, this->r_radius, this->boundary, rules, this->graph
+    );
   }
 }
 
@@ -360,6 +296,9 @@ models::binary_1d_ca::binary_1d_ca(
   const types::rules &rules
 )
 {
+  CA_SCOPED_TIMER(construct);
+  CA_COUNT(cas_constructed, 1);
+
   validate_radii(num_cells, l_radius, r_radius);
   validate_rules(num_cells, l_radius, r_radius, rules);
   validate_ca_size(num_cells);
@@ -371,10 +310,11 @@ models::binary_1d_ca::binary_1d_ca(
   this->num_configs = static_cast<types::whole_num>(1UL << num_cells);
   this->boundary = boundary;
   this->rule_vector = models::rule_vector{rules};
+  this->kernels = &models::ca_kernels::get(l_radius, r_radius, boundary);
 
   this->set_rules(rules);
   this->randomize_config();
-  this->fill_transition_graph();
+  this->load_transition_graph();
   this->fill_sn_maps();
 }
 
@@ -420,6 +360,22 @@ models::binary_1d_ca::get_graph() const
   return this->graph;
 }
 
+// Complementing the rule of a cell complements its next state for every neighborhood.
+// So bit i of `complemented_cells` complements the rule of cell i, by flipping the bit of cell i in every successor.
+types::transition_graph
+models::binary_1d_ca::get_complemented_graph(types::short_whole_num complemented_cells) const
+{
+  types::short_whole_num mask{get_config_mask(complemented_cells, this->num_cells)};
+  types::transition_graph complemented_graph(this->graph.size());
+
+  for (types::whole_num i{}; i < this->graph.size(); i++)
+  {
+    complemented_graph[i] = this->graph[i] ^ mask;
+  }
+
+  return complemented_graph;
+}
+
 const std::vector<types::sn_map> &
 models::binary_1d_ca::get_sn_maps() const
 {
@@ -445,12 +401,45 @@ models::binary_1d_ca::get_current_config() const
   return utils::number::parse_binary_str(current_config_stream.str());
 }
 
+// Additive ECAs jump by powering their affine map, which needs O(log t) matrix products.
+// The others locate the configuration on its orbit in the transition graph.
+// A single query builds the orbit index, so repeated queries should use `models::orbit_index` directly.
+types::short_whole_num
+models::binary_1d_ca::get_future_config(types::short_whole_num config, types::long_whole_num steps) const
+{
+  if (config >= this->num_configs)
+  {
+    throw std::invalid_argument{"Configuration out of range"};
+  }
+
+  if (this->is_elementary() && this->rule_vector.is_additive())
+  {
+    types::long_whole_num future_config{this->rule_vector.get_future_config(
+      this->boundary,
+      get_config_mask(config, this->num_cells),
+      steps
+    )};
+
+    return get_config_mask(future_config, this->num_cells);
+  }
+
+  return models::orbit_index{this->graph}.get_future_config(config, steps);
+}
+
+std::string
+models::binary_1d_ca::get_key() const
+{
+  return models::graph_cache::get_key(this->num_cells, this->l_radius, this->r_radius, this->boundary, this->rule_vector.get_rules());
+}
+
 // This implementation is sub-optimal.
 // The execution of threads continue, even after determining the CA to be isomorphic.
 // This is because there is no way (as per my knowledge) to break out of OMP loops.
 bool
-models::binary_1d_ca::is_isomorphic(const models::binary_1d_ca &other) const
+models::binary_1d_ca::search_isomorphism(const models::binary_1d_ca &other) const
 {
+  CA_SCOPED_TIMER(is_isomorphic);
+
   bool is_isomorphic{};
 
   const types::transition_graph &other_graph{other.get_graph()};
@@ -470,11 +459,16 @@ models::binary_1d_ca::is_isomorphic(const models::binary_1d_ca &other) const
     #pragma omp for
     for (types::short_whole_num i = 0; i < this->num_configs; i++)
     {
+      CA_TRACE_CHUNK("is_isomorphic", i);
+
       if (is_isomorphic)
       {
         continue;
       }
 
+      // Every chunk must start from the identity, as `std::next_permutation` only enumerates from the current arrangement onwards.
+      local_permutation = this_permutation;
+
       std::rotate(
         local_permutation.begin(),
         local_permutation.begin() + i,
@@ -485,9 +479,12 @@ models::binary_1d_ca::is_isomorphic(const models::binary_1d_ca &other) const
       {
         if (is_isomorphic)
         {
+          CA_COUNT(permutations_pruned, 1);
           continue;
         }
 
+        CA_COUNT(permutations_tried, 1);
+
         for (types::short_whole_num j{}; j < local_permutation.size(); j++)
         {
           types::short_whole_num current_config{local_permutation.at(j)};
@@ -496,8 +493,11 @@ models::binary_1d_ca::is_isomorphic(const models::binary_1d_ca &other) const
 
         if (local_graph == other_graph)
         {
+          CA_TRACE_LOCK_REQUEST(is_isomorphic_critical);
+
           #pragma omp critical
           {
+            CA_TRACE_LOCK_ACQUIRED(is_isomorphic_critical);
             is_isomorphic = true;
           }
         }
@@ -523,11 +523,13 @@ models::binary_1d_ca::has_1_1_or_1_n_sn_maps() const
 }
 
 bool
-models::binary_1d_ca::has_non_trivial_reversed_pseudo_isomorphisms(
+models::binary_1d_ca::search_reversed_pseudo_isomorphisms(
   bool &has_trivial_partition,
   bool &has_non_trivial_partitions
 ) const
 {
+  CA_SCOPED_TIMER(reversed_pseudo_isomorphisms);
+
   static auto by_size_desc{[](const auto &obj_1, const auto &obj_2) {
     return obj_1.size() > obj_2.size();
   }};
@@ -571,6 +573,8 @@ models::binary_1d_ca::has_non_trivial_reversed_pseudo_isomorphisms(
   // In such a case, how to store (1UL << 1024) ?
   for (types::long_whole_num i{1}; i < max_combinations; i++)
   {
+    CA_COUNT(subsets_examined, 1);
+
     types::transition_graph current_graph(this->num_configs, USHRT_MAX);
     types::rules current_rules(this->num_cells, 0);
     types::short_whole_num current_cycle{};
@@ -627,43 +631,58 @@ models::binary_1d_ca::has_non_trivial_reversed_pseudo_isomorphisms(
   return has_reversed_isomorphisms;
 }
 
+// Complements of linear ECAs are first matched to the ECA by a translation, found by solving a GF(2) linear system.
+// Otherwise they are compared by their cycle types, which decide isomorphism exactly when both graphs are permutations.
+// The complement of a permutation is a permutation as well, so the full search is needed only for irreversible ECAs whose cycle types match.
 bool
-models::binary_1d_ca::has_all_isomorphic_complements() const
+models::binary_1d_ca::check_all_isomorphic_complements() const
 {
-  models::binary_1d_ca current_ca{};
+  CA_SCOPED_TIMER(isomorphic_complements);
+
+  if (!this->is_elementary())
+  {
+    throw std::domain_error{"Isomorphic complements are only supported for ECAs"};
+  }
+
+  bool is_additive{this->rule_vector.is_additive()};
+  bool is_reversible{this->is_reversible()};
+  std::vector<types::short_whole_num> cycle_type{utils::transition_graph::get_cycle_type(this->get_graph())};
 
   for (types::short_whole_num i{}; i < (1U << this->num_cells); i++)
   {
-    types::short_whole_num current_cell{};
-    types::short_whole_num current_index{i};
-    types::short_whole_num index_mask{static_cast<types::short_whole_num>((1U << this->num_cells) - 1)};
-    types::rules current_rules{};
+    types::long_whole_num translation{};
 
-    while (index_mask)
+    if (is_additive && this->rule_vector.find_complement_translation(this->boundary, i, translation))
     {
-      if (current_index & 1)
-      {
-        current_rules.push_back(255 - this->rule_vector.at(current_cell));
-      }
-      else
+      continue;
+    }
+
+    types::transition_graph complemented_graph{this->get_complemented_graph(i)};
+
+    if (utils::transition_graph::get_cycle_type(complemented_graph) != cycle_type)
+    {
+      return false;
+    }
+
+    if (is_reversible)
+    {
+      continue;
+    }
+
+    // The full search runs on the CA with the complemented rules, so that it is parallel and its result is cached.
+    types::rules complemented_rules{this->rule_vector.get_rules()};
+
+    for (types::short_whole_num j{}; j < this->num_cells; j++)
+    {
+      if ((i >> j) & 1)
       {
-        current_rules.push_back(this->rule_vector.at(current_cell));
+        complemented_rules.at(j) = 255 - complemented_rules.at(j);
       }
-
-      current_index >>= 1;
-      index_mask >>= 1;
-      current_cell += 1;
     }
 
-    current_ca = models::binary_1d_ca{
-      this->num_cells,
-      this->l_radius,
-      this->r_radius,
-      this->boundary,
-      current_rules
-    };
+    models::binary_1d_ca complemented_ca{this->num_cells, this->l_radius, this->r_radius, this->boundary, complemented_rules};
 
-    if (!this->is_isomorphic(current_ca))
+    if (!this->is_isomorphic(complemented_ca))
     {
       return false;
     }
@@ -672,12 +691,61 @@ models::binary_1d_ca::has_all_isomorphic_complements() const
   return true;
 }
 
+bool
+models::binary_1d_ca::is_isomorphic(const models::binary_1d_ca &other) const
+{
+  std::string key{models::result_cache::get_key(this->get_key() + "|" + other.get_key(), "isomorphism", isomorphism_version)};
+
+  return get_cached_result(key, [this, &other]() -> std::string {
+    return this->search_isomorphism(other) ? "1" : "0";
+  }) == "1";
+}
+
+// The result is cached as three flags, the return value followed by the two partition flags.
+bool
+models::binary_1d_ca::has_non_trivial_reversed_pseudo_isomorphisms(
+  bool &has_trivial_partition,
+  bool &has_non_trivial_partitions
+) const
+{
+  std::string key{models::result_cache::get_key(this->get_key(), "reversed_pseudo_isomorphism", reversed_pseudo_isomorphism_version)};
+
+  std::string flags{get_cached_result(key, [this]() -> std::string {
+    bool trivially_partitionable{};
+    bool non_trivially_partitionable{};
+    bool has_reversed_isomorphisms{this->search_reversed_pseudo_isomorphisms(trivially_partitionable, non_trivially_partitionable)};
+
+    return std::string{has_reversed_isomorphisms ? "1" : "0"} + (trivially_partitionable ? "1" : "0") + (non_trivially_partitionable ? "1" : "0");
+  })};
+
+  has_trivial_partition = flags.size() == 3 && flags.at(1) == '1';
+  has_non_trivial_partitions = flags.size() == 3 && flags.at(2) == '1';
+  return flags.size() == 3 && flags.at(0) == '1';
+}
+
+bool
+models::binary_1d_ca::has_all_isomorphic_complements() const
+{
+  std::string key{models::result_cache::get_key(this->get_key(), "isomorphic_complements", isomorphic_complements_version)};
+
+  return get_cached_result(key, [this]() -> std::string {
+    return this->check_all_isomorphic_complements() ? "1" : "0";
+  }) == "1";
+}
+
+// Worker threads hand the rows to an ordered asynchronous writer, so they never wait on terminal I/O.
+// Rows are keyed by (starting node, position within its permutations), which is the order of a serial search.
 void
 models::binary_1d_ca::print_isomorphisms() const
 {
+  CA_SCOPED_TIMER(print_isomorphisms);
+
+  static const types::short_whole_num key_shift{44};
+
   types::long_whole_num counter{};
   const types::transition_graph &this_graph{this->get_graph()};
   std::vector<types::short_whole_num> this_permutation{};
+  types::whole_num max_threads{static_cast<types::whole_num>(omp_get_max_threads())};
 
   for (types::short_whole_num i{}; i < this->num_configs; i++)
   {
@@ -689,17 +757,38 @@ models::binary_1d_ca::print_isomorphisms() const
     std::make_pair<std::string, types::short_whole_num>("Rules", std::max(this->num_cells * 6, 24))
   };
 
-  utils::general::print_header(headings);
+  utils::general::print_header(headings, {output::field_type::number, output::field_type::number_list});
+
+  output::async_writer writer{max_threads, true, [&counter](output::row &entries) {
+    entries.insert(entries.begin(), std::make_pair<std::string, types::short_whole_num>(std::to_string(++counter), 7));
+    utils::general::print_row(entries);
+  }};
 
   #pragma omp parallel
   {
+    types::whole_num thread_num{static_cast<types::whole_num>(omp_get_thread_num())};
     types::transition_graph local_graph(this->num_configs, 0);
     types::rules local_rules(this->num_cells, 0);
     std::vector<types::short_whole_num> local_permutation{this_permutation};
 
+    #pragma omp single nowait
+    {
+      for (types::whole_num i = omp_get_num_threads(); i < max_threads; i++)
+      {
+        writer.finish(i);
+      }
+    }
+
     #pragma omp for
     for (types::short_whole_num i = 0; i < this->num_configs; i++)
     {
+      CA_TRACE_CHUNK("print_isomorphisms", i);
+      types::long_whole_num local_key{static_cast<types::long_whole_num>(i) << key_shift};
+      writer.advance(thread_num, local_key);
+
+      // Every chunk must start from the identity, as `std::next_permutation` only enumerates from the current arrangement onwards.
+      local_permutation = this_permutation;
+
       std::rotate(
         local_permutation.begin(),
         local_permutation.begin() + i,
@@ -708,6 +797,8 @@ models::binary_1d_ca::print_isomorphisms() const
 
       do
       {
+        CA_COUNT(permutations_tried, 1);
+
         for (types::short_whole_num j{}; j < local_permutation.size(); j++)
         {
           types::short_whole_num current_config{local_permutation.at(j)};
@@ -718,21 +809,20 @@ models::binary_1d_ca::print_isomorphisms() const
 
         if (is_valid_ca)
         {
-          #pragma omp critical
-          {
-            std::string rules_str{utils::vector::to_string<types::long_whole_num>(local_rules)};
-
-            std::vector<std::pair<std::string, types::short_whole_num>> entries{
-              std::make_pair<std::string, types::short_whole_num>(std::to_string(++counter), 7),
-              std::make_pair<std::string &, types::short_whole_num>(rules_str, std::max(this->num_cells * 6, 24))
-            };
-
-            utils::general::print_row(entries);
-          }
+          writer.push(thread_num, local_key++, {
+            std::make_pair<std::string, types::short_whole_num>(
+              utils::vector::to_string<types::long_whole_num>(local_rules),
+              std::max(this->num_cells * 6, 24)
+            )
+          });
         }
       } while (std::next_permutation(local_permutation.begin() + 1, local_permutation.end()));
     }
+
+    writer.finish(thread_num);
   }
+
+  writer.close();
 }
 
 void
@@ -746,7 +836,13 @@ models::binary_1d_ca::print_details() const
     std::make_pair<std::string, types::short_whole_num>("Rules", std::max(this->num_cells * 6, 24))
   };
 
-  utils::general::print_header(headings);
+  utils::general::print_header(headings, {
+    output::field_type::number,
+    output::field_type::number,
+    output::field_type::number,
+    output::field_type::text,
+    output::field_type::number_list
+  });
   std::string rules_str{this->rule_vector.to_string()};
 
   std::vector<std::pair<std::string, types::short_whole_num>> entries{
@@ -804,60 +900,66 @@ models::binary_1d_ca::print_sn_maps() const
 void
 models::binary_1d_ca::print_complemented_isomorphisms() const
 {
-  try
+  if (!this->has_complemented_isomorphisms())
   {
-    if (!this->has_complemented_isomorphisms())
-    {
-      utils::general::print_msg("No complemented isomorphisms", colors::blue);
-      return;
-    }
+    utils::general::print_msg("No complemented isomorphisms", colors::blue);
+    return;
+  }
 
-    std::vector<std::pair<std::string, types::short_whole_num>> headings{
-      std::make_pair<std::string, types::short_whole_num>("S. No", 7),
-      std::make_pair<std::string, types::short_whole_num>("Rules", std::max(this->num_cells * 6, 24))
-    };
+  std::vector<std::pair<std::string, types::short_whole_num>> headings{
+    std::make_pair<std::string, types::short_whole_num>("S. No", 7),
+    std::make_pair<std::string, types::short_whole_num>("Rules", std::max(this->num_cells * 6, 24)),
+    std::make_pair<std::string, types::short_whole_num>("Translation", std::max(static_cast<types::num>(this->num_cells), 11))
+  };
 
-    utils::general::print_header(headings);
+  utils::general::print_header(headings, {
+    output::field_type::number,
+    output::field_type::number_list,
+    output::field_type::text
+  });
 
-    for (types::short_whole_num i{}; i < (1U << this->num_cells); i++)
-    {
-      types::short_whole_num current_cell{};
-      types::short_whole_num current_index{i};
-      types::short_whole_num index_mask{static_cast<types::short_whole_num>((1U << this->num_cells) - 1)};
-      types::rules current_rules{};
+  // The ECA is complementable, so (T + I) is invertible and every complement has a translation.
+  for (types::short_whole_num i{}; i < (1U << this->num_cells); i++)
+  {
+    types::long_whole_num translation{};
+    this->rule_vector.find_complement_translation(this->boundary, i, translation);
 
-      while (index_mask)
-      {
-        if (current_index & 1)
-        {
-          current_rules.push_back(255 - this->rule_vector.at(current_cell));
-        }
-        else
-        {
-          current_rules.push_back(this->rule_vector.at(current_cell));
-        }
+    types::short_whole_num current_cell{};
+    types::short_whole_num current_index{i};
+    types::short_whole_num index_mask{static_cast<types::short_whole_num>((1U << this->num_cells) - 1)};
+    types::rules current_rules{};
 
-        current_index >>= 1;
-        index_mask >>= 1;
-        current_cell += 1;
+    while (index_mask)
+    {
+      if (current_index & 1)
+      {
+        current_rules.push_back(255 - this->rule_vector.at(current_cell));
+      }
+      else
+      {
+        current_rules.push_back(this->rule_vector.at(current_cell));
       }
 
-      std::vector<std::pair<std::string, types::short_whole_num>> entries{
-        std::make_pair<std::string, types::short_whole_num>(
-          std::to_string(i + 1), 7
-        ),
-        std::make_pair<std::string, types::short_whole_num>(
-          utils::vector::to_string<types::long_whole_num>(current_rules),
-          std::max(this->num_cells * 6, 24)
-        )
-      };
-
-      utils::general::print_row(entries);
+      current_index >>= 1;
+      index_mask >>= 1;
+      current_cell += 1;
     }
-  }
-  catch (const std::exception &err)
-  {
-    utils::general::print_msg(err.what(), colors::red);
+
+    std::vector<std::pair<std::string, types::short_whole_num>> entries{
+      std::make_pair<std::string, types::short_whole_num>(
+        std::to_string(i + 1), 7
+      ),
+      std::make_pair<std::string, types::short_whole_num>(
+        utils::vector::to_string<types::long_whole_num>(current_rules),
+        std::max(this->num_cells * 6, 24)
+      ),
+      std::make_pair<std::string, types::short_whole_num>(
+        utils::number::to_binary_str(get_config_mask(translation, this->num_cells), this->num_cells),
+        std::max(static_cast<types::num>(this->num_cells), 11)
+      )
+    };
+
+    utils::general::print_row(entries);
   }
 }
 
@@ -951,7 +1053,7 @@ models::binary_1d_ca::print_reversed_pseudo_isomorphisms() const
 
       if (!header_printed)
       {
-        utils::general::print_header(headings);
+        utils::general::print_header(headings, {output::field_type::text, output::field_type::number_list});
         header_printed = true;
       }
 
@@ -968,37 +1070,57 @@ models::binary_1d_ca::print_reversed_pseudo_isomorphisms() const
 void
 models::binary_1d_ca::print_characterisitc_matrix() const
 {
-  try
-  {
-    if (!this->is_elementary())
-    {
-      throw std::domain_error{"Charactersitic matrix is only supported for ECAs"};
-    }
-
-    utils::matrix::print(this->rule_vector.get_characteristic_matrix(this->boundary));
-  }
-  catch (const std::exception &err)
+  if (!this->is_elementary())
   {
-    utils::general::print_msg(err.what(), colors::red);
+    throw std::domain_error{"Charactersitic matrix is only supported for ECAs"};
   }
+
+  utils::matrix::print(this->rule_vector.get_characteristic_matrix(this->boundary));
 }
 
 void
 models::binary_1d_ca::print_characterisitc_polynomial() const
 {
-  try
-  {
-    if (!this->is_elementary())
-    {
-      throw std::domain_error{"Characteristic polynomial is only supported for ECAs"};
-    }
-
-    utils::polynomial::print(this->rule_vector.get_charactersitic_polynomial(this->boundary));
-  }
-  catch (const std::exception &err)
+  if (!this->is_elementary())
   {
-    utils::general::print_msg(err.what(), colors ::red);
+    throw std::domain_error{"Characteristic polynomial is only supported for ECAs"};
   }
+
+  utils::polynomial::print(this->rule_vector.get_charactersitic_polynomial(this->boundary));
+}
+
+void
+models::binary_1d_ca::print_future_config(types::short_whole_num config, types::long_whole_num steps) const
+{
+  std::string steps_str{std::to_string(steps)};
+
+  std::vector<std::pair<std::string, types::short_whole_num>> headings{
+    std::make_pair<std::string, types::short_whole_num>("Configuration", std::max(static_cast<types::num>(this->num_cells), 13)),
+    std::make_pair<std::string, types::short_whole_num>("Steps", std::max(static_cast<types::num>(steps_str.size()), 5)),
+    std::make_pair<std::string, types::short_whole_num>("Future configuration", std::max(static_cast<types::num>(this->num_cells), 20))
+  };
+
+  std::vector<std::pair<std::string, types::short_whole_num>> entries{
+    std::make_pair<std::string, types::short_whole_num>(
+      utils::number::to_binary_str(config, this->num_cells),
+      std::max(static_cast<types::num>(this->num_cells), 13)
+    ),
+    std::make_pair<std::string, types::short_whole_num>(
+      std::string{steps_str},
+      std::max(static_cast<types::num>(steps_str.size()), 5)
+    ),
+    std::make_pair<std::string, types::short_whole_num>(
+      utils::number::to_binary_str(this->get_future_config(config, steps), this->num_cells),
+      std::max(static_cast<types::num>(this->num_cells), 20)
+    )
+  };
+
+  utils::general::print_header(headings, {
+    output::field_type::text,
+    output::field_type::number,
+    output::field_type::text
+  });
+  utils::general::print_row(entries);
 }
 
 void
@@ -1016,6 +1138,9 @@ models::binary_1d_ca::print_rmts_complemented_rules() const
 
   static std::vector<std::vector<types::short_whole_num>> equivalent_rmts{{0, 4}, {1, 5}, {2, 6}, {3, 7}};
 
+  // The complemented CAs are compared by their cycle structures, which are derived from this CA without building them.
+  models::rmt_delta_engine delta_engine{*this};
+
   std::vector<std::pair<std::string, types::short_whole_num>> headings{
     std::make_pair<std::string, types::short_whole_num>("S. No", 7),
     std::make_pair<std::string, types::short_whole_num>("Cell", 4),
@@ -1024,7 +1149,13 @@ models::binary_1d_ca::print_rmts_complemented_rules() const
     std::make_pair<std::string, types::short_whole_num>("Isomorphic", 10)
   };
 
-  utils::general::print_header(headings);
+  utils::general::print_header(headings, {
+    output::field_type::number,
+    output::field_type::number,
+    output::field_type::number_list,
+    output::field_type::number_list,
+    output::field_type::boolean
+  });
 
   for (types::short_whole_num i{}; i < this->num_cells; i++)
   {
@@ -1074,13 +1205,7 @@ models::binary_1d_ca::print_rmts_complemented_rules() const
       models::rule_vector rmts_complemented_rule_vector{this->get_rule_vector()};
       rmts_complemented_rule_vector.at(i) = rmts_complemented_rule;
 
-      bool is_isomorphic{this->has_cycle_strucutre_as(models::binary_1d_ca{
-        this->num_cells,
-        this->l_radius,
-        this->r_radius,
-        this->boundary,
-        rmts_complemented_rule_vector.get_rules()
-      })};
+      bool is_isomorphic{delta_engine.apply(i, rmts_to_complement).cycle_spectrum == delta_engine.get_cycle_spectrum()};
 
       std::vector<std::pair<std::string, types::short_whole_num>> entries{
         std::make_pair<std::string, types::short_whole_num>(
@@ -1114,9 +1239,7 @@ models::binary_1d_ca::tweak_rules() const
   }
 
   types::short_whole_num counter{};
-  types::short_whole_num num_cycles_affected{};
-  models::binary_1d_ca current_ca{};
-  std::unordered_set<types::short_whole_num> affected_configs{};
+  models::rmt_delta_engine delta_engine{*this};
 
   std::vector<std::pair<std::string, types::short_whole_num>> headings{
     std::make_pair<std::string, types::short_whole_num>("S. No", 7),
@@ -1126,7 +1249,13 @@ models::binary_1d_ca::tweak_rules() const
     std::make_pair<std::string, types::short_whole_num>("Cycles Affected", 15)
   };
 
-  utils::general::print_header(headings);
+  utils::general::print_header(headings, {
+    output::field_type::number,
+    output::field_type::number_list,
+    output::field_type::boolean,
+    output::field_type::number,
+    output::field_type::number
+  });
 
   for (types::short_whole_num i{}; i < this->num_cells; i++)
   {
@@ -1144,16 +1273,10 @@ models::binary_1d_ca::tweak_rules() const
       types::rules tweaked_rules{this->get_rule_vector().get_rules()};
       tweaked_rules.at(i) = tweaked_rule;
 
-      current_ca = models::binary_1d_ca{
-        this->num_cells,
-        this->l_radius,
-        this->r_radius,
-        this->boundary,
-        tweaked_rules
-      };
-
-      bool is_isomorphic{this->has_cycle_strucutre_as(current_ca)};
-      affected_configs = this->get_affected_configs(current_ca, num_cycles_affected);
+      // The rule string starts with the highest RMT.
+      types::short_whole_num tweaked_rmt{static_cast<types::short_whole_num>(tweaked_rule_str.size() - 1 - j)};
+      models::rmt_delta delta{delta_engine.apply(i, {tweaked_rmt})};
+      bool is_isomorphic{delta.cycle_spectrum == delta_engine.get_cycle_spectrum()};
 
       std::vector<std::pair<std::string, types::short_whole_num>> entries{
         std::make_pair<std::string, types::short_whole_num>(
@@ -1166,10 +1289,10 @@ models::binary_1d_ca::tweak_rules() const
           is_isomorphic ? "True" : "False", 10
         ),
         std::make_pair<std::string, types::short_whole_num>(
-          std::to_string(affected_configs.size()), 16
+          std::to_string(delta.affected_configs.size()), 16
         ),
         std::make_pair<std::string, types::short_whole_num>(
-          std::to_string(num_cycles_affected), 15
+          std::to_string(delta.num_cycles_affected), 15
         )
       };
 
@@ -1181,13 +1304,11 @@ models::binary_1d_ca::tweak_rules() const
 void
 models::binary_1d_ca::update_config()
 {
-  std::string current_config_str{utils::number::to_binary_str(
-    this->get_current_config(),
-    this->num_cells
-  )};
+  this->set_config(this->get_next_config(this->get_current_config()));
+}
 
-  for (types::short_whole_num i{}; i < this->num_cells; i++)
-  {
-    this->cells.at(i).update_state(this->get_neighborhood_str(i, current_config_str));
-  }
+void
+models::binary_1d_ca::update_config(types::long_whole_num steps)
+{
+  this->set_config(this->get_future_config(this->get_current_config(), steps));
 }
@@ -8,6 +8,7 @@
 
 #include "../../types/types.hpp"
 #include "../binary-cell/binary-cell.hpp"
+#include "../ca-kernels/ca-kernels.hpp"
 #include "../rule-vector/rule-vector.hpp"
 
 namespace models
@@ -27,13 +28,11 @@ namespace models
       types::boundary boundary{};
       types::transition_graph graph{};
       models::rule_vector rule_vector{};
+      const models::ca_kernels *kernels{};
 
       bool
       is_elementary() const;
 
-      bool
-      has_cycle_strucutre_as(const models::binary_1d_ca &other) const;
-
       bool
       has_complemented_isomorphisms() const;
 
@@ -41,30 +40,45 @@ namespace models
       extract_rules(const types::transition_graph &graph, types::rules &rules) const;
 
       types::short_whole_num
-      get_next_config(types::short_whole_num current_config);
-
-      std::string
-      get_neighborhood_str(types::short_whole_num cell_num, const std::string &config_str) const;
-
-      std::unordered_set<types::short_whole_num>
-      get_affected_configs(const models::binary_1d_ca &other, types::short_whole_num &num_cycles_affected) const;
+      get_next_config(types::short_whole_num current_config) const;
 
       void
       set_rules(const types::rules &rules);
 
+      void
+      set_config(types::short_whole_num config);
+
       void
       randomize_config();
 
       void
       fill_transition_graph();
 
+      void
+      load_transition_graph();
+
+      bool
+      search_isomorphism(const models::binary_1d_ca &other) const;
+
+      bool
+      search_reversed_pseudo_isomorphisms(
+        bool &has_trivial_partition,
+        bool &has_non_trivial_partitions
+      ) const;
+
+      bool
+      check_all_isomorphic_complements() const;
+
       void
       fill_sn_maps();
 
     public:
       static const types::short_whole_num max_size{10};
-      static const types::short_whole_num max_l_radius{2};
-      static const types::short_whole_num max_r_radius{2};
+      static const types::short_whole_num max_l_radius{4};
+      static const types::short_whole_num max_r_radius{4};
+
+      // The rules are stored in 64 bits, one for each neighborhood.
+      static const types::short_whole_num max_num_neighbors{6};
 
       binary_1d_ca();
 
@@ -97,6 +111,9 @@ namespace models
       const types::transition_graph &
       get_graph() const;
 
+      types::transition_graph
+      get_complemented_graph(types::short_whole_num complemented_cells) const;
+
       const std::vector<types::sn_map> &
       get_sn_maps() const;
 
@@ -106,6 +123,12 @@ namespace models
       types::short_whole_num
       get_current_config() const;
 
+      types::short_whole_num
+      get_future_config(types::short_whole_num config, types::long_whole_num steps) const;
+
+      std::string
+      get_key() const;
+
       bool
       is_reversible() const;
 
@@ -151,11 +174,17 @@ namespace models
       void
       print_rmts_complemented_rules() const;
 
+      void
+      print_future_config(types::short_whole_num config, types::long_whole_num steps) const;
+
       void
       tweak_rules() const;
 
       void
       update_config();
+
+      void
+      update_config(types::long_whole_num steps);
   };
 }
 
@@ -0,0 +1,194 @@
+#include "ca-kernels.hpp"
+
+#include <array>
+#include <stdexcept>
+
+#include "../../utils/utils.hpp"
+#include "../binary-1d-ca/binary-1d-ca.hpp"
+
+template <types::short_whole_num l_radius, types::short_whole_num r_radius, types::boundary boundary>
+struct shape_kernels
+{
+  static constexpr types::short_whole_num num_neighbors{l_radius + r_radius + 1};
+  static constexpr types::whole_num neighborhood_mask{(1U << num_neighbors) - 1};
+  static constexpr types::whole_num l_halo_mask{(1U << l_radius) - 1};
+
+  // The last l cells wrap around to the left of the lattice, and the first r cells to its right.
+  static types::whole_num
+  get_extended_config(types::short_whole_num config, types::short_whole_num num_cells)
+  {
+    types::whole_num extended_config{static_cast<types::whole_num>(config) << r_radius};
+
+    if constexpr (boundary == types::boundary::periodic)
+    {
+      extended_config |= (config & l_halo_mask) << (num_cells + r_radius);
+      extended_config |= static_cast<types::whole_num>(config) >> (num_cells - r_radius);
+    }
+
+    return extended_config;
+  }
+
+  // Bit j of a configuration is cell (n - 1 - j), so its neighborhood starts at bit j of the extended configuration.
+  static types::short_whole_num
+  get_next_config(types::short_whole_num config, types::short_whole_num num_cells, const types::rules &rules)
+  {
+    types::whole_num extended_config{get_extended_config(config, num_cells)};
+    const types::long_whole_num *last_rule{rules.data() + num_cells - 1};
+    types::whole_num next_config{};
+
+    for (types::short_whole_num j{}; j < num_cells; j++)
+    {
+      next_config |= static_cast<types::whole_num>((last_rule[-j] >> ((extended_config >> j) & neighborhood_mask)) & 1) << j;
+    }
+
+    return static_cast<types::short_whole_num>(next_config);
+  }
+
+  static void
+  fill_transition_graph(types::short_whole_num num_cells, const types::rules &rules, types::transition_graph &graph)
+  {
+    types::whole_num num_configs{1U << num_cells};
+    graph.resize(num_configs);
+
+    for (types::whole_num i{}; i < num_configs; i++)
+    {
+      graph[i] = get_next_config(static_cast<types::short_whole_num>(i), num_cells, rules);
+    }
+  }
+
+  // Bit p of `seen` and `next_states` records whether neighborhood p occurred, and the next state it led to.
+  static bool
+  extract_rules(types::short_whole_num num_cells, const types::transition_graph &graph, types::rules &rules)
+  {
+    std::array<types::long_whole_num, models::binary_1d_ca::max_size> seen{};
+    std::array<types::long_whole_num, models::binary_1d_ca::max_size> next_states{};
+
+    for (types::whole_num i{}; i < graph.size(); i++)
+    {
+      types::whole_num extended_config{get_extended_config(static_cast<types::short_whole_num>(i), num_cells)};
+
+      for (types::short_whole_num j{}; j < num_cells; j++)
+      {
+        types::long_whole_num neighborhood_bit{1UL << ((extended_config >> j) & neighborhood_mask)};
+        types::long_whole_num next_state{static_cast<types::long_whole_num>((graph[i] >> j) & 1) * neighborhood_bit};
+
+        if ((seen[j] & neighborhood_bit) && (next_states[j] & neighborhood_bit) != next_state)
+        {
+          return false;
+        }
+
+        seen[j] |= neighborhood_bit;
+        next_states[j] |= next_state;
+      }
+    }
+
+    for (types::short_whole_num j{}; j < num_cells; j++)
+    {
+      rules.at(num_cells - 1 - j) = next_states[j];
+    }
+
+    return true;
+  }
+
+  // Only the configurations with a predecessor are mapped, so the next configurations are read off the graph twice.
+  static void
+  fill_sn_maps(types::short_whole_num num_cells, const types::transition_graph &graph, std::vector<types::sn_map> &sn_maps)
+  {
+    // Bit p of `seen[j][s]` is set when cell (n - 1 - j) in state s is followed by neighborhood p.
+    std::array<std::array<types::long_whole_num, 2>, models::binary_1d_ca::max_size> seen{};
+
+    for (const auto &config : graph)
+    {
+      types::whole_num next_extended_config{get_extended_config(graph[config], num_cells)};
+
+      for (types::short_whole_num j{}; j < num_cells; j++)
+      {
+        seen[j][(config >> j) & 1] |= 1UL << ((next_extended_config >> j) & neighborhood_mask);
+      }
+    }
+
+    sn_maps.assign(num_cells, {});
+
+    for (types::short_whole_num j{}; j < num_cells; j++)
+    {
+      types::sn_map &sn_map{sn_maps.at(num_cells - 1 - j)};
+
+      for (types::short_whole_num state{}; state < 2; state++)
+      {
+        std::unordered_set<std::string> &neighborhoods{sn_map[static_cast<char>('0' + state)]};
+        types::long_whole_num remaining_neighborhoods{seen[j][state]};
+
+        while (remaining_neighborhoods)
+        {
+          neighborhoods.insert(utils::number::to_binary_str(__builtin_ctzl(remaining_neighborhoods), num_neighbors));
+          remaining_neighborhoods &= remaining_neighborhoods - 1;
+        }
+      }
+    }
+  }
+};
+
+using kernels_table = std::array<
+  std::array<std::array<models::ca_kernels, 2>, models::binary_1d_ca::max_r_radius + 1>,
+  models::binary_1d_ca::max_l_radius + 1
+>;
+
+// Instantiates the kernels of every supported shape, walking the radii in row major order.
+template <types::short_whole_num l_radius, types::short_whole_num r_radius>
+static void
+fill_kernels_table(kernels_table &table)
+{
+  if constexpr (l_radius + r_radius + 1 <= models::binary_1d_ca::max_num_neighbors)
+  {
+    using null_kernels = shape_kernels<l_radius, r_radius, types::boundary::null>;
+    using periodic_kernels = shape_kernels<l_radius, r_radius, types::boundary::periodic>;
+
+    table[l_radius][r_radius][types::boundary::null] = {
+      null_kernels::get_next_config,
+      null_kernels::fill_transition_graph,
+      null_kernels::extract_rules,
+      null_kernels::fill_sn_maps
+    };
+
+    table[l_radius][r_radius][types::boundary::periodic] = {
+      periodic_kernels::get_next_config,
+      periodic_kernels::fill_transition_graph,
+      periodic_kernels::extract_rules,
+      periodic_kernels::fill_sn_maps
+    };
+  }
+
+  if constexpr (r_radius < models::binary_1d_ca::max_r_radius)
+  {
+    fill_kernels_table<l_radius, r_radius + 1>(table);
+  }
+  else if constexpr (l_radius < models::binary_1d_ca::max_l_radius)
+  {
+    fill_kernels_table<l_radius + 1, 0>(table);
+  }
+}
+
+static kernels_table
+get_kernels_table()
+{
+  kernels_table table{};
+  fill_kernels_table<0, 0>(table);
+  return table;
+}
+
+const models::ca_kernels &
+models::ca_kernels::get(types::short_whole_num l_radius, types::short_whole_num r_radius, types::boundary boundary)
+{
+  static const kernels_table table{get_kernels_table()};
+
+  if (
+    l_radius > models::binary_1d_ca::max_l_radius ||
+    r_radius > models::binary_1d_ca::max_r_radius ||
+    table[l_radius][r_radius][boundary].get_next_config == nullptr
+  )
+  {
+    throw std::invalid_argument{"Unsupported radius"};
+  }
+
+  return table[l_radius][r_radius][boundary];
+}
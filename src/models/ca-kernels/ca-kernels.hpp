@@ -0,0 +1,49 @@
+#ifndef __CA_KERNELS__
+#define __CA_KERNELS__
+
+#include <vector>
+
+#include "../../types/types.hpp"
+
+namespace models
+{
+  // The inner loops of `binary_1d_ca`, compiled once for every shape of neighborhood and boundary.
+  //
+  // A configuration is unrolled into its cells with the boundary cells on either side, so that cell i is bit (n - 1 - i + r).
+  // The neighborhood of cell i is then the l + r + 1 bits from bit (n - 1 - i), with the leftmost neighbor as the most significant bit.
+  // The radii and the boundary are template parameters, so the masks are constants and no cell takes a branch.
+  //
+  // The kernels of a shape are looked up at run time, once per CA.
+  struct ca_kernels
+  {
+    types::short_whole_num (*get_next_config)(
+      types::short_whole_num config,
+      types::short_whole_num num_cells,
+      const types::rules &rules
+    ){};
+
+    void (*fill_transition_graph)(
+      types::short_whole_num num_cells,
+      const types::rules &rules,
+      types::transition_graph &graph
+    ){};
+
+    // Neighborhoods that never occur are set to 0 in the rules.
+    bool (*extract_rules)(
+      types::short_whole_num num_cells,
+      const types::transition_graph &graph,
+      types::rules &rules
+    ){};
+
+    void (*fill_sn_maps)(
+      types::short_whole_num num_cells,
+      const types::transition_graph &graph,
+      std::vector<types::sn_map> &sn_maps
+    ){};
+
+    static const models::ca_kernels &
+    get(types::short_whole_num l_radius, types::short_whole_num r_radius, types::boundary boundary);
+  };
+}
+
+#endif
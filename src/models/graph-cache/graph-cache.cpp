@@ -0,0 +1,219 @@
+#include "graph-cache.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <sstream>
+
+#include "../../utils/utils.hpp"
+
+static const char graph_file_magic[4]{'C', 'A', 'G', '1'};
+static std::string cache_directory{};
+
+static std::string
+get_file_path(const std::string &key)
+{
+  return cache_directory + "/" + utils::number::to_hex_str(utils::number::get_hash(key), 16) + ".cag";
+}
+
+static void
+append_bytes(std::string &buffer, const void *data, std::size_t size)
+{
+  buffer.append(static_cast<const char *>(data), size);
+}
+
+models::mapped_graph::mapped_graph(const char *data, std::size_t size)
+{
+  this->data = data;
+  this->size = size;
+}
+
+models::mapped_graph::~mapped_graph()
+{
+  munmap(const_cast<char *>(this->data), this->size);
+}
+
+const models::graph_file_header &
+models::mapped_graph::get_header() const
+{
+  return *reinterpret_cast<const models::graph_file_header *>(this->data);
+}
+
+const types::short_whole_num *
+models::mapped_graph::get_successors() const
+{
+  return reinterpret_cast<const types::short_whole_num *>(this->data + this->get_header().graph_offset);
+}
+
+void
+models::graph_cache::set_directory(const std::string &path)
+{
+  if (!path.empty())
+  {
+    utils::file::make_directory(path);
+  }
+
+  cache_directory = path;
+}
+
+const std::string &
+models::graph_cache::get_directory()
+{
+  return cache_directory;
+}
+
+bool
+models::graph_cache::is_enabled()
+{
+  return !cache_directory.empty();
+}
+
+std::string
+models::graph_cache::get_key(
+  types::short_whole_num num_cells,
+  types::short_whole_num l_radius,
+  types::short_whole_num r_radius,
+  types::boundary boundary,
+  const types::rules &rules
+)
+{
+  std::ostringstream key_stream{};
+
+  key_stream << "n=" << num_cells;
+  key_stream << ";l=" << l_radius;
+  key_stream << ";r=" << r_radius;
+  key_stream << ";b=" << (boundary == types::boundary::null ? "null" : "periodic");
+  key_stream << ";rules=";
+
+  for (types::short_whole_num i{}; i < rules.size(); i++)
+  {
+    key_stream << (i == 0 ? "" : ",") << rules.at(i);
+  }
+
+  return key_stream.str();
+}
+
+// A file that doesn't match the requested CA exactly is treated as a miss.
+// This guards against hash collisions, and against files from other versions of the format.
+std::unique_ptr<models::mapped_graph>
+models::graph_cache::map(
+  types::short_whole_num num_cells,
+  types::short_whole_num l_radius,
+  types::short_whole_num r_radius,
+  types::boundary boundary,
+  const types::rules &rules
+)
+{
+  if (!models::graph_cache::is_enabled())
+  {
+    return nullptr;
+  }
+
+  std::string path{get_file_path(models::graph_cache::get_key(num_cells, l_radius, r_radius, boundary, rules))};
+  int file_descriptor{open(path.c_str(), O_RDONLY)};
+
+  if (file_descriptor < 0)
+  {
+    return nullptr;
+  }
+
+  struct stat file_stat{};
+  void *data{MAP_FAILED};
+
+  if (fstat(file_descriptor, &file_stat) == 0 && static_cast<std::size_t>(file_stat.st_size) >= sizeof(models::graph_file_header))
+  {
+    data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+  }
+
+  close(file_descriptor);
+
+  if (data == MAP_FAILED)
+  {
+    return nullptr;
+  }
+
+  std::size_t size{static_cast<std::size_t>(file_stat.st_size)};
+  auto graph{std::make_unique<models::mapped_graph>(static_cast<const char *>(data), size)};
+  const models::graph_file_header &header{graph->get_header()};
+
+  std::uint64_t num_configs{1UL << num_cells};
+
+  // The section bounds are compared as counts of the space left, so corrupt offsets can't overflow past `size`.
+  bool is_valid{
+    std::memcmp(header.magic, graph_file_magic, sizeof(graph_file_magic)) == 0 &&
+    header.version == models::graph_cache::version &&
+    header.num_cells == num_cells &&
+    header.l_radius == l_radius &&
+    header.r_radius == r_radius &&
+    header.boundary == boundary &&
+    header.entry_size == sizeof(types::short_whole_num) &&
+    header.num_configs == num_configs &&
+    header.rules_offset <= size &&
+    rules.size() <= (size - header.rules_offset) / sizeof(std::uint64_t) &&
+    header.graph_offset <= size &&
+    header.graph_offset % alignof(types::short_whole_num) == 0 &&
+    num_configs <= (size - header.graph_offset) / sizeof(types::short_whole_num)
+  };
+
+  for (types::short_whole_num i{}; is_valid && i < rules.size(); i++)
+  {
+    std::uint64_t current_rule{};
+    std::memcpy(&current_rule, static_cast<const char *>(data) + header.rules_offset + i * sizeof(std::uint64_t), sizeof(std::uint64_t));
+    is_valid = current_rule == rules.at(i);
+  }
+
+  // A successor out of range would be indexed by every walk of the graph, so a damaged file is a miss too.
+  const types::short_whole_num *successors{is_valid ? graph->get_successors() : nullptr};
+
+  for (std::uint64_t config{}; is_valid && config < num_configs; config++)
+  {
+    is_valid = successors[config] < num_configs;
+  }
+
+  return is_valid ? std::move(graph) : nullptr;
+}
+
+// Storing is best effort, as a cache that can't be written must not fail the analysis.
+void
+models::graph_cache::store(
+  types::short_whole_num num_cells,
+  types::short_whole_num l_radius,
+  types::short_whole_num r_radius,
+  types::boundary boundary,
+  const types::rules &rules,
+  const types::transition_graph &graph
+)
+{
+  if (!models::graph_cache::is_enabled())
+  {
+    return;
+  }
+
+  models::graph_file_header header{};
+  std::memcpy(header.magic, graph_file_magic, sizeof(graph_file_magic));
+  header.version = models::graph_cache::version;
+  header.num_cells = num_cells;
+  header.l_radius = l_radius;
+  header.r_radius = r_radius;
+  header.boundary = boundary;
+  header.entry_size = sizeof(types::short_whole_num);
+  header.num_configs = graph.size();
+  header.rules_offset = sizeof(models::graph_file_header);
+  header.graph_offset = header.rules_offset + rules.size() * sizeof(std::uint64_t);
+
+  std::string buffer{};
+  append_bytes(buffer, &header, sizeof(header));
+
+  for (const auto &rule : rules)
+  {
+    std::uint64_t current_rule{rule};
+    append_bytes(buffer, &current_rule, sizeof(current_rule));
+  }
+
+  append_bytes(buffer, graph.data(), graph.size() * sizeof(types::short_whole_num));
+
+  utils::file::write_atomically(get_file_path(models::graph_cache::get_key(num_cells, l_radius, r_radius, boundary, rules)), buffer);
+}
@@ -0,0 +1,104 @@
+#ifndef __GRAPH_CACHE__
+#define __GRAPH_CACHE__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "../../types/types.hpp"
+
+namespace models
+{
+  // A transition graph file is laid out as below, with all the fields in native byte order.
+  //   1. A fixed size header, holding the CA parameters and the offsets of the sections that follow.
+  //   2. The rule of every cell, as 64-bit numbers.
+  //   3. The successor of every configuration, `entry_size` bytes each.
+  struct graph_file_header
+  {
+    char magic[4]{};
+    std::uint32_t version{};
+    std::uint16_t num_cells{};
+    std::uint16_t l_radius{};
+    std::uint16_t r_radius{};
+    std::uint16_t boundary{};
+    std::uint32_t entry_size{};
+    std::uint32_t reserved{};
+    std::uint64_t num_configs{};
+    std::uint64_t rules_offset{};
+    std::uint64_t graph_offset{};
+  };
+
+  // A read-only view of a transition graph file, mapped into memory.
+  // The pages are shared, so concurrent processes reading the same graph keep a single copy in memory.
+  class mapped_graph
+  {
+    private:
+      const char *data{};
+      std::size_t size{};
+
+    public:
+      mapped_graph(const char *data, std::size_t size);
+
+      mapped_graph(const mapped_graph &other) = delete;
+
+      mapped_graph &
+      operator=(const mapped_graph &other) = delete;
+
+      ~mapped_graph();
+
+      const models::graph_file_header &
+      get_header() const;
+
+      const types::short_whole_num *
+      get_successors() const;
+  };
+
+  // Transition graphs are stored in a directory, under a file named by the hash of the CA parameters.
+  // Files are written to a temporary name and then renamed, so readers never see a partially written graph.
+  // The cache is disabled until a directory is set.
+  class graph_cache
+  {
+    public:
+      static const std::uint32_t version{2};
+
+      static void
+      set_directory(const std::string &path);
+
+      static const std::string &
+      get_directory();
+
+      static bool
+      is_enabled();
+
+      static std::string
+      get_key(
+        types::short_whole_num num_cells,
+        types::short_whole_num l_radius,
+        types::short_whole_num r_radius,
+        types::boundary boundary,
+        const types::rules &rules
+      );
+
+      static std::unique_ptr<models::mapped_graph>
+      map(
+        types::short_whole_num num_cells,
+        types::short_whole_num l_radius,
+        types::short_whole_num r_radius,
+        types::boundary boundary,
+        const types::rules &rules
+      );
+
+      static void
+      store(
+        types::short_whole_num num_cells,
+        types::short_whole_num l_radius,
+        types::short_whole_num r_radius,
+        types::boundary boundary,
+        const types::rules &rules,
+        const types::transition_graph &graph
+      );
+  };
+}
+
+#endif
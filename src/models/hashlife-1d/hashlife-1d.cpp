@@ -0,0 +1,557 @@
+#include "hashlife-1d.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "../../instrument/instrument.hpp"
+#include "../../terminal/terminal.hpp"
+#include "../../utils/utils.hpp"
+#include "../stepper/stepper.hpp"
+
+static const types::short_whole_num leaf_level{2};
+static const types::short_whole_num leaf_size{1U << leaf_level};
+
+// 2^exponent can overflow for long jumps, so it is reduced while doubling.
+types::long_whole_num
+models::hashlife_1d::get_power_of_two_mod(types::short_whole_num exponent) const
+{
+  types::long_whole_num power{1 % this->num_cells};
+
+  for (types::short_whole_num i{}; i < exponent; i++)
+  {
+    power = (power * 2) % this->num_cells;
+  }
+
+  return power;
+}
+
+types::whole_num
+models::hashlife_1d::get_leaf(types::short_whole_num bits, types::long_whole_num phase)
+{
+  types::long_whole_num key{(phase << leaf_size) | bits};
+  auto found{this->leaf_ids.find(key)};
+
+  if (found != this->leaf_ids.end())
+  {
+    return found->second;
+  }
+
+  types::whole_num id{static_cast<types::whole_num>(this->nodes.size())};
+  this->nodes.push_back({leaf_level, 0, 0, bits, phase});
+  this->leaf_ids.emplace(key, id);
+
+  return id;
+}
+
+// The phase of a block is the phase of its left half.
+types::whole_num
+models::hashlife_1d::join(types::whole_num left, types::whole_num right)
+{
+  types::long_whole_num key{(static_cast<types::long_whole_num>(left) << 32) | right};
+  auto found{this->branch_ids.find(key)};
+
+  if (found != this->branch_ids.end())
+  {
+    return found->second;
+  }
+
+  types::whole_num id{static_cast<types::whole_num>(this->nodes.size())};
+  types::short_whole_num level{static_cast<types::short_whole_num>(this->nodes.at(left).level + 1)};
+  types::long_whole_num phase{this->nodes.at(left).phase};
+
+  this->nodes.push_back({level, left, right, 0, phase});
+  this->branch_ids.emplace(key, id);
+
+  return id;
+}
+
+// The center half of a block, without advancing it.
+types::whole_num
+models::hashlife_1d::get_center(types::whole_num id)
+{
+  models::hashlife_node node{this->nodes.at(id)};
+
+  if (node.level == leaf_level + 1)
+  {
+    types::short_whole_num left_bits{this->nodes.at(node.left).bits};
+    types::short_whole_num right_bits{this->nodes.at(node.right).bits};
+
+    return this->get_leaf(
+      static_cast<types::short_whole_num>(((left_bits & 3) << 2) | (right_bits >> 2)),
+      (node.phase + 2) % this->rules.size()
+    );
+  }
+
+  return this->join(this->nodes.at(node.left).right, this->nodes.at(node.right).left);
+}
+
+// The base case steps the center 4 of 8 cells once, which needs at most 2 neighbors on either side.
+types::whole_num
+models::hashlife_1d::step_leaves(types::whole_num id)
+{
+  models::hashlife_node node{this->nodes.at(id)};
+  types::short_whole_num cells{static_cast<types::short_whole_num>(
+    (this->nodes.at(node.left).bits << leaf_size) | this->nodes.at(node.right).bits
+  )};
+  types::short_whole_num next_bits{};
+
+  for (types::short_whole_num i{2}; i < 2 + leaf_size; i++)
+  {
+    types::long_whole_num neighborhood{};
+
+    for (types::short_whole_num j{static_cast<types::short_whole_num>(i - this->l_radius)}; j <= i + this->r_radius; j++)
+    {
+      neighborhood = (neighborhood << 1) | ((cells >> (2 * leaf_size - 1 - j)) & 1);
+    }
+
+    types::long_whole_num rule{this->rules.at((node.phase + i) % this->rules.size())};
+    next_bits = static_cast<types::short_whole_num>((next_bits << 1) | ((rule >> neighborhood) & 1));
+  }
+
+  return this->get_leaf(next_bits, (node.phase + 2) % this->rules.size());
+}
+
+// The block [a b] is advanced through its three overlapping halves a, [a.right b.left] and b.
+// Their results are joined in pairs and advanced again, which gives the center half of the block.
+// A full jump advances both stages by half the steps, while shorter jumps only take the centers in the first stage.
+// Once a jump fills the cache, the remaining calls return at once, and nothing more is memoized.
+types::whole_num
+models::hashlife_1d::advance(types::whole_num id, types::short_whole_num log_steps)
+{
+  if (this->is_cache_full)
+  {
+    return 0;
+  }
+
+  types::long_whole_num key{(static_cast<types::long_whole_num>(id) << 6) | log_steps};
+  auto found{this->results.find(key)};
+
+  if (found != this->results.end())
+  {
+    CA_COUNT(hashlife_hits, 1);
+    return found->second;
+  }
+
+  CA_COUNT(hashlife_misses, 1);
+
+  if (this->nodes.size() > this->max_nodes)
+  {
+    this->is_cache_full = true;
+    return 0;
+  }
+
+  models::hashlife_node node{this->nodes.at(id)};
+  types::whole_num result{};
+
+  if (node.level == leaf_level + 1)
+  {
+    result = this->step_leaves(id);
+  }
+  else
+  {
+    types::whole_num middle{this->join(this->nodes.at(node.left).right, this->nodes.at(node.right).left)};
+    bool is_full_jump{log_steps == node.level - 3};
+    std::vector<types::whole_num> halves{node.left, middle, node.right};
+
+    for (auto &half : halves)
+    {
+      half = is_full_jump ? this->advance(half, log_steps - 1) : this->get_center(half);
+    }
+
+    types::short_whole_num next_log_steps{static_cast<types::short_whole_num>(is_full_jump ? log_steps - 1 : log_steps)};
+
+    result = this->join(
+      this->advance(this->join(halves.at(0), halves.at(1)), next_log_steps),
+      this->advance(this->join(halves.at(1), halves.at(2)), next_log_steps)
+    );
+  }
+
+  if (!this->is_cache_full)
+  {
+    this->results.emplace(key, result);
+  }
+
+  return result;
+}
+
+// The periodic lattice is unrolled into a block starting at cell `start`.
+// Blocks are shared by their level and starting cell, so every level holds at most one block per cell.
+types::whole_num
+models::hashlife_1d::build_window(
+  types::short_whole_num level,
+  types::long_whole_num start,
+  std::unordered_map<types::long_whole_num, types::whole_num> &windows
+)
+{
+  types::long_whole_num key{(start << 7) | level};
+  auto found{windows.find(key)};
+
+  if (found != windows.end())
+  {
+    return found->second;
+  }
+
+  types::whole_num id{};
+
+  if (level == leaf_level)
+  {
+    types::short_whole_num bits{};
+
+    for (types::short_whole_num i{}; i < leaf_size; i++)
+    {
+      bits = static_cast<types::short_whole_num>((bits << 1) | (this->config_str.at((start + i) % this->num_cells) == '1'));
+    }
+
+    id = this->get_leaf(bits, start % this->rules.size());
+  }
+  else
+  {
+    types::long_whole_num half_start{(start + this->get_power_of_two_mod(level - 1)) % this->num_cells};
+    types::whole_num left{this->build_window(level - 1, start, windows)};
+    types::whole_num right{this->build_window(level - 1, half_start, windows)};
+    id = this->join(left, right);
+  }
+
+  windows.emplace(key, id);
+  return id;
+}
+
+// Only the cells before `num_cells` are read, so the replicas of the lattice in a wide block are skipped.
+void
+models::hashlife_1d::read_cells(types::whole_num id, types::long_whole_num start, std::string &cells) const
+{
+  if (start >= this->num_cells)
+  {
+    return;
+  }
+
+  const models::hashlife_node &node{this->nodes.at(id)};
+
+  if (node.level == leaf_level)
+  {
+    for (types::short_whole_num i{}; i < leaf_size && start + i < this->num_cells; i++)
+    {
+      cells.at(start + i) = ((node.bits >> (leaf_size - 1 - i)) & 1) ? '1' : '0';
+    }
+
+    return;
+  }
+
+  this->read_cells(node.left, start, cells);
+
+  // Halves of 2^63 cells or more start beyond any lattice.
+  if (node.level - 1 < 63)
+  {
+    this->read_cells(node.right, start + (1UL << (node.level - 1)), cells);
+  }
+}
+
+// A block of 2^k cells gives its center 2^(k - 1) cells, so it must be wide enough for both the jump and the lattice.
+// The block starts 2^(k - 2) cells before the first cell, so that its center starts at the first cell.
+bool
+models::hashlife_1d::try_jump(types::short_whole_num log_steps)
+{
+  CA_SCOPED_TIMER(hashlife_jump);
+
+  if (this->nodes.size() > this->max_nodes)
+  {
+    this->collect_garbage();
+  }
+
+  types::short_whole_num level{static_cast<types::short_whole_num>(log_steps + 3)};
+
+  while (level - 1 < 63 && (1UL << (level - 1)) < this->num_cells)
+  {
+    level += 1;
+  }
+
+  types::long_whole_num start{(this->num_cells - this->get_power_of_two_mod(level - 2)) % this->num_cells};
+  std::unordered_map<types::long_whole_num, types::whole_num> windows{};
+  types::whole_num window{this->build_window(level, start, windows)};
+
+  types::whole_num result{this->advance(window, log_steps)};
+
+  if (this->is_cache_full)
+  {
+    this->is_cache_full = false;
+    return false;
+  }
+
+  this->read_cells(result, 0, this->config_str);
+  return true;
+}
+
+// A jump that overflows the cache is retried from an empty cache, and the cache is emptied again if it overflows even then.
+bool
+models::hashlife_1d::jump(types::short_whole_num log_steps)
+{
+  bool is_empty{this->nodes.empty()};
+
+  if (this->try_jump(log_steps))
+  {
+    return true;
+  }
+
+  this->results.clear();
+  this->collect_garbage();
+
+  if (!is_empty && this->try_jump(log_steps))
+  {
+    return true;
+  }
+
+  this->results.clear();
+  this->collect_garbage();
+  return false;
+}
+
+// Dynamics that don't repeat gain nothing from memoization, so the cells are stepped by a bitsliced stepper instead.
+void
+models::hashlife_1d::step(types::long_whole_num steps)
+{
+  CA_SCOPED_TIMER(hashlife_step);
+
+  models::stepper stepper{this->num_cells, this->l_radius, this->r_radius, types::boundary::periodic, this->rules, models::stepper_kernel::bitsliced};
+  std::vector<types::long_whole_num> config{models::stepper::pack(this->config_str)};
+  std::vector<types::long_whole_num> next_config{};
+
+  for (types::long_whole_num i{}; i < steps; i++)
+  {
+    stepper.step(config, next_config);
+    config.swap(next_config);
+  }
+
+  this->config_str = models::stepper::unpack(config, this->num_cells);
+}
+
+models::hashlife_1d::hashlife_1d(
+  types::long_whole_num num_cells,
+  types::short_whole_num l_radius,
+  types::short_whole_num r_radius,
+  const types::rules &rules,
+  types::long_whole_num max_nodes
+)
+{
+  if (num_cells == 0 || num_cells > models::hashlife_1d::max_size)
+  {
+    throw std::invalid_argument{"Unsupported cellular automata size"};
+  }
+
+  if (l_radius > models::hashlife_1d::max_radius || r_radius > models::hashlife_1d::max_radius)
+  {
+    throw std::invalid_argument{"Unsupported radius"};
+  }
+
+  types::short_whole_num num_neighbors{static_cast<types::short_whole_num>(l_radius + r_radius + 1)};
+
+  if (num_neighbors > num_cells)
+  {
+    throw std::invalid_argument{"Neighborhood size can't be greater than CA size"};
+  }
+
+  if (rules.empty() || num_cells % rules.size() != 0)
+  {
+    throw std::invalid_argument{"The rules must repeat a whole number of times along the lattice"};
+  }
+
+  for (const auto &rule : rules)
+  {
+    if (rule >= (1UL << (1U << num_neighbors)))
+    {
+      throw std::invalid_argument{"Invalid rule: " + std::to_string(rule)};
+    }
+  }
+
+  this->num_cells = num_cells;
+  this->l_radius = l_radius;
+  this->r_radius = r_radius;
+  this->rules = rules;
+  this->max_nodes = max_nodes;
+  this->config_str = std::string(num_cells, '0');
+}
+
+types::long_whole_num
+models::hashlife_1d::get_num_cells() const
+{
+  return this->num_cells;
+}
+
+types::long_whole_num
+models::hashlife_1d::get_num_nodes() const
+{
+  return this->nodes.size();
+}
+
+const std::string &
+models::hashlife_1d::get_config() const
+{
+  return this->config_str;
+}
+
+void
+models::hashlife_1d::set_config(const std::string &config_str)
+{
+  if (config_str.size() != this->num_cells || config_str.find_first_not_of("01") != std::string::npos)
+  {
+    throw std::invalid_argument{"Invalid configuration"};
+  }
+
+  this->config_str = config_str;
+}
+
+void
+models::hashlife_1d::randomize_config()
+{
+  for (auto &cell : this->config_str)
+  {
+    cell = utils::general::get_random_bool() ? '1' : '0';
+  }
+}
+
+// The steps are taken as jumps of powers of two, the longest first.
+// Once a jump doesn't fit in the cache, it and the remaining jumps are stepped directly.
+void
+models::hashlife_1d::update_config(types::long_whole_num steps)
+{
+  for (types::short_num i{63}; i >= 0; i--)
+  {
+    if (((steps >> i) & 1) && !this->jump(static_cast<types::short_whole_num>(i)))
+    {
+      this->step(steps & ((2UL << i) - 1));
+      return;
+    }
+  }
+}
+
+// The results of the longest jumps summarize the most work, so they are kept first, along with the nodes they need.
+// They may hold up to half of the cache, and everything else is dropped.
+// The surviving nodes are renumbered in their old order, which keeps every node after its halves.
+void
+models::hashlife_1d::collect_garbage()
+{
+  CA_SCOPED_TIMER(hashlife_gc);
+
+  std::vector<std::pair<types::long_whole_num, types::whole_num>> entries{this->results.begin(), this->results.end()};
+  std::vector<bool> is_alive(this->nodes.size(), false);
+  std::vector<types::whole_num> pending_ids{};
+  types::long_whole_num num_alive{};
+
+  std::sort(entries.begin(), entries.end(), [](const auto &obj_1, const auto &obj_2) {
+    return (obj_1.first & 63) > (obj_2.first & 63);
+  });
+
+  for (const auto &entry : entries)
+  {
+    if (num_alive >= this->max_nodes / 2)
+    {
+      break;
+    }
+
+    pending_ids.push_back(static_cast<types::whole_num>(entry.first >> 6));
+    pending_ids.push_back(entry.second);
+
+    while (!pending_ids.empty())
+    {
+      types::whole_num current_id{pending_ids.back()};
+      pending_ids.pop_back();
+
+      if (is_alive.at(current_id))
+      {
+        continue;
+      }
+
+      is_alive.at(current_id) = true;
+      num_alive += 1;
+
+      if (this->nodes.at(current_id).level > leaf_level)
+      {
+        pending_ids.push_back(this->nodes.at(current_id).left);
+        pending_ids.push_back(this->nodes.at(current_id).right);
+      }
+    }
+  }
+
+  std::vector<types::whole_num> new_ids(this->nodes.size(), 0);
+  std::vector<models::hashlife_node> alive_nodes{};
+  alive_nodes.reserve(num_alive);
+
+  this->leaf_ids.clear();
+  this->branch_ids.clear();
+
+  for (types::whole_num i{}; i < this->nodes.size(); i++)
+  {
+    if (!is_alive.at(i))
+    {
+      continue;
+    }
+
+    models::hashlife_node node{this->nodes.at(i)};
+    types::whole_num id{static_cast<types::whole_num>(alive_nodes.size())};
+    new_ids.at(i) = id;
+
+    if (node.level == leaf_level)
+    {
+      this->leaf_ids.emplace((node.phase << leaf_size) | node.bits, id);
+    }
+    else
+    {
+      node.left = new_ids.at(node.left);
+      node.right = new_ids.at(node.right);
+      this->branch_ids.emplace((static_cast<types::long_whole_num>(node.left) << 32) | node.right, id);
+    }
+
+    alive_nodes.push_back(node);
+  }
+
+  std::unordered_map<types::long_whole_num, types::whole_num> alive_results{};
+
+  for (const auto &entry : entries)
+  {
+    types::whole_num key_id{static_cast<types::whole_num>(entry.first >> 6)};
+
+    if (is_alive.at(key_id) && is_alive.at(entry.second))
+    {
+      alive_results.emplace((static_cast<types::long_whole_num>(new_ids.at(key_id)) << 6) | (entry.first & 63), new_ids.at(entry.second));
+    }
+  }
+
+  this->nodes = std::move(alive_nodes);
+  this->results = std::move(alive_results);
+}
+
+void
+models::hashlife_1d::print_summary(types::long_whole_num steps) const
+{
+  std::string steps_str{std::to_string(steps)};
+  types::long_whole_num num_ones{static_cast<types::long_whole_num>(std::count(this->config_str.begin(), this->config_str.end(), '1'))};
+
+  std::vector<std::pair<std::string, types::short_whole_num>> headings{
+    std::make_pair<std::string, types::short_whole_num>("Cells", 10),
+    std::make_pair<std::string, types::short_whole_num>("Steps", std::max(static_cast<types::num>(steps_str.size()), 5)),
+    std::make_pair<std::string, types::short_whole_num>("Ones", 10),
+    std::make_pair<std::string, types::short_whole_num>("Nodes", 10)
+  };
+
+  std::vector<std::pair<std::string, types::short_whole_num>> entries{
+    std::make_pair<std::string, types::short_whole_num>(std::to_string(this->num_cells), 10),
+    std::make_pair<std::string, types::short_whole_num>(
+      std::string{steps_str}, std::max(static_cast<types::num>(steps_str.size()), 5)
+    ),
+    std::make_pair<std::string, types::short_whole_num>(std::to_string(num_ones), 10),
+    std::make_pair<std::string, types::short_whole_num>(std::to_string(this->nodes.size()), 10)
+  };
+
+  utils::general::print_header(headings, {
+    output::field_type::number,
+    output::field_type::number,
+    output::field_type::number,
+    output::field_type::number
+  });
+  utils::general::print_row(entries);
+
+  // Long lattices would flood the terminal, so only short configurations are printed.
+  if (this->num_cells <= 128)
+  {
+    utils::general::print_msg(this->config_str, colors::cyan);
+  }
+}
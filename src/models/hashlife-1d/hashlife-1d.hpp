@@ -0,0 +1,128 @@
+#ifndef __HASHLIFE_1D__
+#define __HASHLIFE_1D__
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../types/types.hpp"
+
+namespace models
+{
+  // A block of 2^level cells, split into two halves of 2^(level - 1) cells.
+  // Blocks of 4 cells are leaves, and hold the cells directly, with the first cell as the most significant bit.
+  // The phase is the position of the first cell modulo the period of the rules, which decides the rule of every cell.
+  struct hashlife_node
+  {
+    types::short_whole_num level{};
+    types::whole_num left{};
+    types::whole_num right{};
+    types::short_whole_num bits{};
+    types::long_whole_num phase{};
+  };
+
+  // HashLife for 1D CAs with a periodic boundary, on lattices much larger than `binary_1d_ca` supports.
+  //
+  // Every block is stored once, and the center half of a block of 2^k cells after 2^j steps is memoized, for any j <= k - 3.
+  // It is built from the results of overlapping sub-blocks, so repeated patterns in space and time are computed only once.
+  // So the dynamics that repeat advance exponentially fast, as a jump of 2^j steps reuses the results of the shorter jumps.
+  //
+  // The rules repeat along the lattice, so uniform CAs have a single rule.
+  // Blocks with the same cells but different phases are different nodes, which keeps hybrid rules exact.
+  // The memory is bounded by collecting the nodes not needed by the results of the longest jumps, once the cache is full.
+  // A jump that would overflow the cache even when it starts empty is abandoned, and the rest of the run is stepped directly.
+  class hashlife_1d
+  {
+    private:
+      types::long_whole_num num_cells{};
+      types::short_whole_num l_radius{};
+      types::short_whole_num r_radius{};
+      types::rules rules{};
+      types::long_whole_num max_nodes{};
+      bool is_cache_full{};
+      std::string config_str{};
+
+      std::vector<models::hashlife_node> nodes{};
+      std::unordered_map<types::long_whole_num, types::whole_num> leaf_ids{};
+      std::unordered_map<types::long_whole_num, types::whole_num> branch_ids{};
+      std::unordered_map<types::long_whole_num, types::whole_num> results{};
+
+      types::long_whole_num
+      get_power_of_two_mod(types::short_whole_num exponent) const;
+
+      types::whole_num
+      get_leaf(types::short_whole_num bits, types::long_whole_num phase);
+
+      types::whole_num
+      join(types::whole_num left, types::whole_num right);
+
+      types::whole_num
+      get_center(types::whole_num id);
+
+      types::whole_num
+      step_leaves(types::whole_num id);
+
+      types::whole_num
+      advance(types::whole_num id, types::short_whole_num log_steps);
+
+      types::whole_num
+      build_window(
+        types::short_whole_num level,
+        types::long_whole_num start,
+        std::unordered_map<types::long_whole_num, types::whole_num> &windows
+      );
+
+      void
+      read_cells(types::whole_num id, types::long_whole_num start, std::string &cells) const;
+
+      bool
+      try_jump(types::short_whole_num log_steps);
+
+      bool
+      jump(types::short_whole_num log_steps);
+
+      void
+      step(types::long_whole_num steps);
+
+    public:
+      static const types::long_whole_num max_size{1UL << 20};
+
+      // The base case steps the center of 8 cells, so it sees at most 2 neighbors on either side.
+      static const types::short_whole_num max_radius{2};
+      static const types::long_whole_num default_max_nodes{1UL << 22};
+
+      hashlife_1d(
+        types::long_whole_num num_cells,
+        types::short_whole_num l_radius,
+        types::short_whole_num r_radius,
+        const types::rules &rules,
+        types::long_whole_num max_nodes = default_max_nodes
+      );
+
+      types::long_whole_num
+      get_num_cells() const;
+
+      types::long_whole_num
+      get_num_nodes() const;
+
+      const std::string &
+      get_config() const;
+
+      void
+      set_config(const std::string &config_str);
+
+      void
+      randomize_config();
+
+      void
+      update_config(types::long_whole_num steps);
+
+      void
+      collect_garbage();
+
+      void
+      print_summary(types::long_whole_num steps) const;
+  };
+}
+
+#endif
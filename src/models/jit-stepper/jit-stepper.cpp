@@ -0,0 +1,381 @@
+#include "jit-stepper.hpp"
+
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#include "../../utils/utils.hpp"
+#include "../rule-program/rule-program.hpp"
+#include "../stepper/stepper.hpp"
+
+static const types::short_whole_num word_size{64};
+static const types::short_whole_num num_checked_configs{16};
+
+static std::string
+get_word_literal(types::long_whole_num word)
+{
+  return "0x" + utils::number::to_hex_str(word, 16) + "UL";
+}
+
+static types::long_whole_num
+get_low_mask(types::short_whole_num count)
+{
+  return count >= word_size ? ~0UL : (1UL << count) - 1;
+}
+
+static std::string
+get_register_name(types::short_whole_num register_num, types::short_whole_num num_neighbors)
+{
+  return (register_num < num_neighbors ? "x" : "t") + std::to_string(register_num);
+}
+
+static std::string
+get_instruction_code(const models::rule_instruction &instruction, types::short_whole_num num_neighbors)
+{
+  std::string a{get_register_name(instruction.a, num_neighbors)};
+  std::string b{get_register_name(instruction.b, num_neighbors)};
+
+  switch (instruction.op)
+  {
+    case models::rule_op::and_op:
+      return a + " & " + b;
+
+    case models::rule_op::or_op:
+      return a + " | " + b;
+
+    case models::rule_op::xor_op:
+      return a + " ^ " + b;
+
+    case models::rule_op::and_not_op:
+      return a + " & ~" + b;
+
+    case models::rule_op::not_op:
+      return "~" + a;
+
+    case models::rule_op::zero_op:
+      return "0UL";
+
+    case models::rule_op::ones_op:
+      return "~0UL";
+  }
+
+  return a;
+}
+
+// Cell i of the padded buffer `p` is bit (i + 64), as in `stepper`, so the neighbor words are read at constant offsets.
+std::string
+models::jit_stepper::get_source(
+  types::long_whole_num num_cells,
+  types::short_whole_num l_radius,
+  types::short_whole_num r_radius,
+  types::boundary boundary,
+  const types::rules &rules
+)
+{
+  types::long_whole_num num_words{(num_cells + word_size - 1) / word_size};
+  types::short_whole_num num_neighbors{static_cast<types::short_whole_num>(l_radius + r_radius + 1)};
+  types::long_whole_num last_word_mask{get_low_mask(static_cast<types::short_whole_num>(num_cells - (num_words - 1) * word_size))};
+
+  std::map<types::long_whole_num, models::rule_program> programs{};
+
+  for (const auto &rule : rules)
+  {
+    programs.emplace(rule, models::rule_program{rule, l_radius, r_radius});
+  }
+
+  std::ostringstream source{};
+
+  source << "// Generated by jit_stepper, for " << num_cells << " cells with l = " << l_radius << " and r = " << r_radius;
+  source << " and a " << (boundary == types::boundary::null ? "null" : "periodic") << " boundary.\n";
+  source << "extern \"C\" void\n";
+  source << "ca_step(const unsigned long *config, unsigned long *next_config)\n";
+  source << "{\n";
+  source << "  unsigned long p[" << num_words + 2 << "]{};\n\n";
+  source << "  for (unsigned long j = 0; j < " << num_words << "; j++)\n";
+  source << "  {\n";
+  source << "    p[j + 1] = config[j];\n";
+  source << "  }\n\n";
+  source << "  p[" << num_words << "] &= " << get_word_literal(last_word_mask) << ";\n";
+
+  if (boundary == types::boundary::periodic)
+  {
+    for (types::short_whole_num l{1}; l <= l_radius; l++)
+    {
+      types::long_whole_num cell_num{(num_cells - l % num_cells) % num_cells};
+      source << "  p[0] |= ((config[" << cell_num / word_size << "] >> " << cell_num % word_size << ") & 1UL) << " << word_size - l << ";\n";
+    }
+
+    for (types::short_whole_num r{}; r < r_radius; r++)
+    {
+      types::long_whole_num cell_num{r % num_cells};
+      types::long_whole_num bit_num{word_size + num_cells + r};
+      source << "  p[" << bit_num / word_size << "] |= ((config[" << cell_num / word_size << "] >> " << cell_num % word_size << ") & 1UL) << ";
+      source << bit_num % word_size << ";\n";
+    }
+  }
+
+  for (types::long_whole_num j{}; j < num_words; j++)
+  {
+    source << "\n  {\n";
+
+    for (types::short_whole_num k{}; k < num_neighbors; k++)
+    {
+      types::num offset{k - l_radius};
+      types::long_whole_num word_num{offset < 0 ? j : j + 1};
+      types::short_whole_num shift{static_cast<types::short_whole_num>(offset < 0 ? word_size + offset : offset)};
+
+      source << "    const unsigned long " << get_register_name(k, num_neighbors) << " = ";
+
+      if (shift == 0)
+      {
+        source << "p[" << word_num << "];\n";
+      }
+      else
+      {
+        source << "(p[" << word_num << "] >> " << shift << ") | (p[" << word_num + 1 << "] << " << word_size - shift << ");\n";
+      }
+    }
+
+    std::map<types::long_whole_num, types::long_whole_num> rule_masks{};
+
+    for (types::long_whole_num i{j * word_size}; i < num_cells && i < (j + 1) * word_size; i++)
+    {
+      rule_masks[rules.at(i % rules.size())] |= 1UL << (i % word_size);
+    }
+
+    source << "    unsigned long next_word = 0;\n";
+
+    for (const auto &rule_mask : rule_masks)
+    {
+      const models::rule_program &program{programs.at(rule_mask.first)};
+      types::short_whole_num register_num{num_neighbors};
+
+      source << "\n    {\n";
+
+      for (const auto &instruction : program.get_instructions())
+      {
+        source << "      const unsigned long " << get_register_name(register_num++, num_neighbors) << " = ";
+        source << get_instruction_code(instruction, num_neighbors) << ";\n";
+      }
+
+      source << "      next_word |= " << get_register_name(program.get_output(), num_neighbors) << " & " << get_word_literal(rule_mask.second) << ";\n";
+      source << "    }\n";
+    }
+
+    source << "\n    next_config[" << j << "] = next_word;\n";
+    source << "  }\n";
+  }
+
+  source << "}\n";
+
+  return source.str();
+}
+
+// A library runs inside the process as soon as it is loaded, before it can be checked.
+// So only a directory that no one else can write to, say by planting a library under a predictable hash, is used.
+static void
+make_cache_directory(const std::string &path)
+{
+  utils::file::make_directory(path, 0700);
+
+  struct stat directory_stat{};
+
+  if (
+    stat(path.c_str(), &directory_stat) != 0 ||
+    !S_ISDIR(directory_stat.st_mode) ||
+    directory_stat.st_uid != geteuid() ||
+    (directory_stat.st_mode & (S_IWGRP | S_IWOTH)) != 0
+  )
+  {
+    throw std::runtime_error{"The JIT cache " + path + " must be a directory owned by the current user, and not writable by others"};
+  }
+}
+
+// The compiler is run directly rather than through a shell, so neither it nor the paths are interpreted.
+// It is split into words, so that a launcher such as `ccache g++` works.
+// The library is written to a temporary file and renamed, so that other processes never load a partial one.
+static void
+compile_library(const std::string &compiler, const std::string &source_path, const std::string &library_path)
+{
+  std::string tmp_path{library_path + ".tmp." + std::to_string(getpid())};
+  std::istringstream compiler_stream{compiler};
+  std::vector<std::string> args{};
+  std::string current_arg{};
+
+  while (compiler_stream >> current_arg)
+  {
+    args.push_back(current_arg);
+  }
+
+  if (args.empty())
+  {
+    throw std::runtime_error{"No compiler given in CXX"};
+  }
+
+  args.insert(args.end(), {"-O3", "-shared", "-fPIC", "-o", tmp_path, source_path});
+  std::vector<char *> argv{};
+
+  for (auto &arg : args)
+  {
+    argv.push_back(const_cast<char *>(arg.c_str()));
+  }
+
+  argv.push_back(nullptr);
+
+  pid_t pid{fork()};
+
+  if (pid < 0)
+  {
+    throw std::runtime_error{"Cannot fork"};
+  }
+
+  if (pid == 0)
+  {
+    execvp(argv.at(0), argv.data());
+    _exit(127);
+  }
+
+  int status{};
+  waitpid(pid, &status, 0);
+
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || std::rename(tmp_path.c_str(), library_path.c_str()) != 0)
+  {
+    std::remove(tmp_path.c_str());
+    throw std::runtime_error{"Cannot compile " + source_path + " with " + compiler};
+  }
+}
+
+// All 0s, all 1s, and random configurations, drawn from a fixed seed so the global random streams are untouched.
+static bool
+matches_reference(const models::jit_stepper &jit_stepper, const models::stepper &reference)
+{
+  std::mt19937_64 generator{jit_stepper.get_num_cells()};
+  std::vector<types::long_whole_num> config((jit_stepper.get_num_cells() + word_size - 1) / word_size);
+  std::vector<types::long_whole_num> expected_config{};
+  std::vector<types::long_whole_num> next_config{};
+
+  for (types::short_whole_num i{}; i < num_checked_configs; i++)
+  {
+    for (auto &word : config)
+    {
+      word = i == 0 ? 0 : (i == 1 ? ~0UL : generator());
+    }
+
+    reference.step(config, expected_config);
+    jit_stepper.step(config, next_config);
+
+    if (next_config != expected_config)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+models::jit_stepper::jit_stepper(
+  types::long_whole_num num_cells,
+  types::short_whole_num l_radius,
+  types::short_whole_num r_radius,
+  types::boundary boundary,
+  const types::rules &rules,
+  const std::string &cache_directory
+)
+{
+  if (num_cells > models::jit_stepper::max_size)
+  {
+    throw std::invalid_argument{"Unsupported cellular automata size"};
+  }
+
+  // The generic stepper validates the CA, and is the reference the library is checked against.
+  models::stepper reference{num_cells, l_radius, r_radius, boundary, rules, models::stepper_kernel::scalar};
+
+  const char *compiler_env{std::getenv("CXX")};
+  std::string compiler{compiler_env != nullptr && *compiler_env != '\0' ? compiler_env : "g++"};
+  std::string source{models::jit_stepper::get_source(num_cells, l_radius, r_radius, boundary, rules)};
+  std::string path{
+    cache_directory + "/" + utils::number::to_hex_str(utils::number::get_hash(compiler + "\n" + source), 16)
+  };
+
+  this->num_cells = num_cells;
+  this->library_path = path + ".so";
+
+  make_cache_directory(cache_directory);
+
+  // A cached library that loads but doesn't match, say from an older compiler, is removed and compiled once more.
+  bool is_compiled{};
+  void *handle{dlopen(this->library_path.c_str(), RTLD_NOW | RTLD_LOCAL)};
+
+  while (true)
+  {
+    if (handle == nullptr)
+    {
+      if (!utils::file::write_atomically(path + ".cpp", source))
+      {
+        throw std::runtime_error{"Cannot write " + path + ".cpp"};
+      }
+
+      compile_library(compiler, path + ".cpp", this->library_path);
+      is_compiled = true;
+      handle = dlopen(this->library_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+
+      if (handle == nullptr)
+      {
+        throw std::runtime_error{"Cannot load " + this->library_path + " - " + dlerror()};
+      }
+    }
+
+    this->library = std::shared_ptr<void>{handle, dlclose};
+    this->step_library = reinterpret_cast<step_function>(dlsym(handle, "ca_step"));
+
+    if (this->step_library != nullptr && matches_reference(*this, reference))
+    {
+      return;
+    }
+
+    if (is_compiled)
+    {
+      throw std::runtime_error{"The library " + this->library_path + " doesn't match the generic stepper"};
+    }
+
+    this->library.reset();
+    this->step_library = nullptr;
+    std::remove(this->library_path.c_str());
+    handle = nullptr;
+  }
+}
+
+types::long_whole_num
+models::jit_stepper::get_num_cells() const
+{
+  return this->num_cells;
+}
+
+const std::string &
+models::jit_stepper::get_library_path() const
+{
+  return this->library_path;
+}
+
+void
+models::jit_stepper::step(const std::vector<types::long_whole_num> &config, std::vector<types::long_whole_num> &next_config) const
+{
+  types::long_whole_num num_words{(this->num_cells + word_size - 1) / word_size};
+
+  if (config.size() < num_words)
+  {
+    throw std::invalid_argument{"The configuration has fewer cells than the stepper"};
+  }
+
+  next_config.resize(num_words);
+  this->step_library(config.data(), next_config.data());
+  next_config[num_words - 1] &= get_low_mask(static_cast<types::short_whole_num>(this->num_cells - (num_words - 1) * word_size));
+}
@@ -0,0 +1,65 @@
+#ifndef __JIT_STEPPER__
+#define __JIT_STEPPER__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../types/types.hpp"
+
+namespace models
+{
+  // A stepper generated for one lattice, compiled with the system compiler and loaded with `dlopen`.
+  //
+  // The generated step is unrolled over the words of the lattice, so every shift, boundary cell and rule mask is a constant.
+  // Every word runs the formulas of its rules, from `rule_program`, which the compiler is free to schedule and share.
+  //
+  // Libraries are cached in a directory, by the hash of their source, so a lattice is compiled only the first time it is run.
+  // A loaded library is checked against the scalar `stepper` on a few configurations before it is used.
+  // The check can't catch a malicious library, so the cache directory must belong to the user, and be writable by no one else.
+  // The compiler is `$CXX`, split into words, or `g++` when it isn't set.
+  class jit_stepper
+  {
+    private:
+      using step_function = void (*)(const types::long_whole_num *config, types::long_whole_num *next_config);
+
+      types::long_whole_num num_cells{};
+      std::string library_path{};
+      std::shared_ptr<void> library{};
+      step_function step_library{};
+
+    public:
+      // Larger lattices take too long to compile, unrolled.
+      static const types::long_whole_num max_size{1UL << 16};
+
+      jit_stepper(
+        types::long_whole_num num_cells,
+        types::short_whole_num l_radius,
+        types::short_whole_num r_radius,
+        types::boundary boundary,
+        const types::rules &rules,
+        const std::string &cache_directory
+      );
+
+      static std::string
+      get_source(
+        types::long_whole_num num_cells,
+        types::short_whole_num l_radius,
+        types::short_whole_num r_radius,
+        types::boundary boundary,
+        const types::rules &rules
+      );
+
+      types::long_whole_num
+      get_num_cells() const;
+
+      const std::string &
+      get_library_path() const;
+
+      // The configurations use the layout of `stepper`, and must not alias.
+      void
+      step(const std::vector<types::long_whole_num> &config, std::vector<types::long_whole_num> &next_config) const;
+  };
+}
+
+#endif
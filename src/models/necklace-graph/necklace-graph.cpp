@@ -0,0 +1,310 @@
+#include "necklace-graph.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "../../terminal/terminal.hpp"
+#include "../../utils/utils.hpp"
+#include "../binary-1d-ca/binary-1d-ca.hpp"
+
+types::long_whole_num
+models::necklace_graph::rotate(types::long_whole_num config, types::short_whole_num shift) const
+{
+  if (shift == 0)
+  {
+    return config;
+  }
+
+  types::long_whole_num mask{(1UL << this->num_cells) - 1};
+  return ((config << shift) | (config >> (this->num_cells - shift))) & mask;
+}
+
+// This is the FKM algorithm, which generates the necklaces in increasing order, in constant amortized time per necklace.
+// Every prenecklace a[1..n] is extended from the last one, and is a necklace when its period divides n.
+// Refer, Ruskey, "Combinatorial Generation", Section 7.2.
+void
+models::necklace_graph::fill_necklaces()
+{
+  std::vector<types::short_whole_num> digits(this->num_cells + 1, 0);
+  types::short_whole_num i{this->num_cells};
+
+  this->necklaces.push_back(0);
+  this->periods.push_back(1);
+
+  while (true)
+  {
+    while (i > 0 && digits.at(i) == 1)
+    {
+      i -= 1;
+    }
+
+    if (i == 0)
+    {
+      break;
+    }
+
+    digits.at(i) = 1;
+
+    for (types::short_whole_num j{1}; j <= this->num_cells - i; j++)
+    {
+      digits.at(i + j) = digits.at(j);
+    }
+
+    if (this->num_cells % i == 0)
+    {
+      types::long_whole_num necklace{};
+
+      for (types::short_whole_num j{1}; j <= this->num_cells; j++)
+      {
+        necklace = (necklace << 1) | digits.at(j);
+      }
+
+      this->necklaces.push_back(necklace);
+      this->periods.push_back(i);
+    }
+
+    i = this->num_cells;
+  }
+}
+
+// The successor of a necklace is computed directly on its bits, with the left neighbors at the more significant positions.
+void
+models::necklace_graph::fill_successors()
+{
+  this->successors.resize(this->necklaces.size());
+  this->shifts.resize(this->necklaces.size());
+
+  for (types::long_whole_num i{}; i < this->necklaces.size(); i++)
+  {
+    types::long_whole_num config{this->necklaces.at(i)};
+    types::long_whole_num next_config{};
+
+    for (types::num position{}; position < this->num_cells; position++)
+    {
+      types::long_whole_num neighborhood{};
+
+      for (types::num offset{this->l_radius}; offset >= -static_cast<types::num>(this->r_radius); offset--)
+      {
+        types::num neighbor_position{(position + offset + this->num_cells) % this->num_cells};
+        neighborhood = (neighborhood << 1) | ((config >> neighbor_position) & 1);
+      }
+
+      next_config |= ((this->rule >> neighborhood) & 1) << position;
+    }
+
+    types::short_whole_num shift{};
+    this->successors.at(i) = static_cast<types::whole_num>(this->find_necklace(next_config, shift));
+    this->shifts.at(i) = shift;
+  }
+}
+
+models::necklace_graph::necklace_graph(
+  types::short_whole_num num_cells,
+  types::short_whole_num l_radius,
+  types::short_whole_num r_radius,
+  types::long_whole_num rule
+)
+{
+  if (num_cells == 0 || num_cells > models::necklace_graph::max_size)
+  {
+    throw std::invalid_argument{"Unsupported cellular automata size"};
+  }
+
+  if (l_radius > models::binary_1d_ca::max_l_radius || r_radius > models::binary_1d_ca::max_r_radius)
+  {
+    throw std::invalid_argument{"Unsupported radius"};
+  }
+
+  types::short_whole_num num_neighbors{static_cast<types::short_whole_num>(l_radius + r_radius + 1)};
+
+  if (num_neighbors > models::binary_1d_ca::max_num_neighbors)
+  {
+    throw std::invalid_argument{"Unsupported neighborhood size"};
+  }
+
+  if (num_neighbors > num_cells)
+  {
+    throw std::invalid_argument{"Neighborhood size can't be greater than CA size"};
+  }
+
+  if (num_neighbors < 6 && rule >= (1UL << (1U << num_neighbors)))
+  {
+    throw std::invalid_argument{"Invalid rule: " + std::to_string(rule)};
+  }
+
+  this->num_cells = num_cells;
+  this->l_radius = l_radius;
+  this->r_radius = r_radius;
+  this->rule = rule;
+
+  this->fill_necklaces();
+  this->fill_successors();
+}
+
+types::short_whole_num
+models::necklace_graph::get_num_cells() const
+{
+  return this->num_cells;
+}
+
+types::long_whole_num
+models::necklace_graph::get_num_necklaces() const
+{
+  return this->necklaces.size();
+}
+
+types::long_whole_num
+models::necklace_graph::get_necklace(types::long_whole_num index) const
+{
+  return this->necklaces.at(index);
+}
+
+types::long_whole_num
+models::necklace_graph::find_necklace(types::long_whole_num config, types::short_whole_num &shift) const
+{
+  types::long_whole_num necklace{config};
+  types::short_whole_num min_rotation{};
+
+  for (types::short_whole_num i{1}; i < this->num_cells; i++)
+  {
+    types::long_whole_num rotated_config{this->rotate(config, i)};
+
+    if (rotated_config < necklace)
+    {
+      necklace = rotated_config;
+      min_rotation = i;
+    }
+  }
+
+  shift = (this->num_cells - min_rotation) % this->num_cells;
+  return std::lower_bound(this->necklaces.begin(), this->necklaces.end(), necklace) - this->necklaces.begin();
+}
+
+types::long_whole_num
+models::necklace_graph::get_next_config(types::long_whole_num config) const
+{
+  types::short_whole_num shift{};
+  types::long_whole_num index{this->find_necklace(config, shift)};
+
+  return this->rotate(
+    this->necklaces.at(this->successors.at(index)),
+    (this->shifts.at(index) + shift) % this->num_cells
+  );
+}
+
+// Rotating commutes with the CA, so it maps the rotations of a necklace onto the rotations of its successor.
+// This map is a bijection only when both the necklaces have the same number of distinct rotations.
+// So the CA is reversible if and only if every necklace has exactly one predecessor, with the same period.
+bool
+models::necklace_graph::is_reversible() const
+{
+  std::vector<bool> has_predecessor(this->necklaces.size(), false);
+
+  for (types::long_whole_num i{}; i < this->necklaces.size(); i++)
+  {
+    types::whole_num successor{this->successors.at(i)};
+
+    if (has_predecessor.at(successor) || this->periods.at(successor) != this->periods.at(i))
+    {
+      return false;
+    }
+
+    has_predecessor.at(successor) = true;
+  }
+
+  return true;
+}
+
+// A cycle of L necklaces returns to its first necklace rotated by the sum S of the shifts along it.
+// All the necklaces of such a cycle have the same period p, and rotating by S has order p / gcd(S, p) on them.
+// So the cycle stands for gcd(S, p) cycles of the full graph, each of length L * p / gcd(S, p).
+std::vector<models::necklace_cycle>
+models::necklace_graph::get_cycles() const
+{
+  static const types::short_whole_num unvisited{0};
+  static const types::short_whole_num in_progress{1};
+  static const types::short_whole_num visited{2};
+
+  std::vector<models::necklace_cycle> cycles{};
+  std::vector<types::short_whole_num> states(this->necklaces.size(), unvisited);
+
+  for (types::long_whole_num i{}; i < this->necklaces.size(); i++)
+  {
+    types::long_whole_num current_node{i};
+
+    while (states.at(current_node) == unvisited)
+    {
+      states.at(current_node) = in_progress;
+      current_node = this->successors.at(current_node);
+    }
+
+    if (states.at(current_node) == in_progress)
+    {
+      types::long_whole_num start_node{current_node};
+      types::long_whole_num length{};
+      types::long_whole_num total_shift{};
+
+      do
+      {
+        length += 1;
+        total_shift += this->shifts.at(current_node);
+        current_node = this->successors.at(current_node);
+      } while (current_node != start_node);
+
+      types::long_whole_num period{this->periods.at(start_node)};
+      types::long_whole_num count{std::gcd(total_shift % period, period)};
+
+      cycles.push_back({this->necklaces.at(start_node), length * (period / count), count});
+    }
+
+    current_node = i;
+
+    while (states.at(current_node) == in_progress)
+    {
+      states.at(current_node) = visited;
+      current_node = this->successors.at(current_node);
+    }
+  }
+
+  return cycles;
+}
+
+std::map<types::long_whole_num, types::long_whole_num>
+models::necklace_graph::get_cycle_spectrum() const
+{
+  std::map<types::long_whole_num, types::long_whole_num> spectrum{};
+
+  for (const auto &cycle : this->get_cycles())
+  {
+    spectrum[cycle.length] += cycle.count;
+  }
+
+  return spectrum;
+}
+
+void
+models::necklace_graph::print_cycle_spectrum() const
+{
+  std::vector<std::pair<std::string, types::short_whole_num>> headings{
+    std::make_pair<std::string, types::short_whole_num>("Cycle Length", 12),
+    std::make_pair<std::string, types::short_whole_num>("No. of Cycles", 13)
+  };
+
+  utils::general::print_header(headings, {output::field_type::number, output::field_type::number});
+
+  for (const auto &entry : this->get_cycle_spectrum())
+  {
+    std::vector<std::pair<std::string, types::short_whole_num>> entries{
+      std::make_pair<std::string, types::short_whole_num>(std::to_string(entry.first), 12),
+      std::make_pair<std::string, types::short_whole_num>(std::to_string(entry.second), 13)
+    };
+
+    utils::general::print_row(entries);
+  }
+
+  utils::general::print_msg(
+    "Necklaces: " + std::to_string(this->necklaces.size()) + ", Reversible: " + (this->is_reversible() ? "True" : "False"),
+    colors::cyan
+  );
+}
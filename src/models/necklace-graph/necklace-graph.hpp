@@ -0,0 +1,90 @@
+#ifndef __NECKLACE_GRAPH__
+#define __NECKLACE_GRAPH__
+
+#include <map>
+#include <vector>
+
+#include "../../types/types.hpp"
+
+namespace models
+{
+  // A class of cycles of the transition graph.
+  // There are `count` cycles of length `length`, one of which passes through the configuration `start`.
+  struct necklace_cycle
+  {
+    types::long_whole_num start{};
+    types::long_whole_num length{};
+    types::long_whole_num count{};
+  };
+
+  // The transition graph of a uniform CA with a periodic boundary, compressed by rotation.
+  // Such a CA commutes with rotating its cells, so the successor of a rotated configuration is the rotated successor.
+  // Only one configuration of every rotation class (necklace) is stored, as the smallest of its rotations.
+  // For every necklace, the necklace of its successor is stored, along with the rotation that gives the successor.
+  // That is roughly 2^n / n nodes instead of 2^n, so much larger CAs fit.
+  //
+  // Configurations use the same encoding as `binary_1d_ca`, i.e. the first cell is the most significant bit.
+  class necklace_graph
+  {
+    private:
+      types::short_whole_num num_cells{};
+      types::short_whole_num l_radius{};
+      types::short_whole_num r_radius{};
+      types::long_whole_num rule{};
+
+      std::vector<types::long_whole_num> necklaces{};
+      std::vector<types::whole_num> successors{};
+      std::vector<types::short_whole_num> shifts{};
+      std::vector<types::short_whole_num> periods{};
+
+      types::long_whole_num
+      rotate(types::long_whole_num config, types::short_whole_num shift) const;
+
+      void
+      fill_necklaces();
+
+      void
+      fill_successors();
+
+    public:
+      static const types::short_whole_num max_size{24};
+
+      necklace_graph(
+        types::short_whole_num num_cells,
+        types::short_whole_num l_radius,
+        types::short_whole_num r_radius,
+        types::long_whole_num rule
+      );
+
+      types::short_whole_num
+      get_num_cells() const;
+
+      types::long_whole_num
+      get_num_necklaces() const;
+
+      types::long_whole_num
+      get_necklace(types::long_whole_num index) const;
+
+      types::long_whole_num
+      get_next_config(types::long_whole_num config) const;
+
+      // Returns the index of the necklace of a configuration, and the rotation that gives the configuration from it.
+      types::long_whole_num
+      find_necklace(types::long_whole_num config, types::short_whole_num &shift) const;
+
+      bool
+      is_reversible() const;
+
+      std::vector<models::necklace_cycle>
+      get_cycles() const;
+
+      // Maps every cycle length to the number of cycles of that length.
+      std::map<types::long_whole_num, types::long_whole_num>
+      get_cycle_spectrum() const;
+
+      void
+      print_cycle_spectrum() const;
+  };
+}
+
+#endif
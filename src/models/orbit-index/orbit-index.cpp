@@ -0,0 +1,108 @@
+#include "orbit-index.hpp"
+
+#include <stdexcept>
+
+// Every orbit is walked until it meets a configuration seen before.
+// If it was seen on the current walk, the rest of the walk from there is a new cycle.
+// The configurations before that are tails, and are resolved backwards from the configuration they lead into.
+models::orbit_index::orbit_index(const types::transition_graph &graph)
+{
+  static const types::short_whole_num unvisited{0};
+  static const types::short_whole_num in_progress{1};
+  static const types::short_whole_num visited{2};
+
+  this->graph = graph;
+  this->tail_lengths.resize(graph.size(), 0);
+  this->cycle_ids.resize(graph.size(), 0);
+  this->entry_positions.resize(graph.size(), 0);
+
+  std::vector<types::short_whole_num> states(graph.size(), unvisited);
+  std::vector<types::short_whole_num> path{};
+
+  for (types::whole_num i{}; i < graph.size(); i++)
+  {
+    types::short_whole_num current_config{static_cast<types::short_whole_num>(i)};
+    path.clear();
+
+    while (states.at(current_config) == unvisited)
+    {
+      states.at(current_config) = in_progress;
+      path.push_back(current_config);
+      current_config = graph.at(current_config);
+    }
+
+    types::whole_num tail_end{static_cast<types::whole_num>(path.size())};
+
+    if (states.at(current_config) == in_progress)
+    {
+      types::whole_num cycle_id{static_cast<types::whole_num>(this->cycles.size())};
+      std::vector<types::short_whole_num> cycle{};
+
+      while (path.at(tail_end - 1) != current_config)
+      {
+        tail_end -= 1;
+      }
+
+      tail_end -= 1;
+
+      for (types::whole_num j{tail_end}; j < path.size(); j++)
+      {
+        this->cycle_ids.at(path.at(j)) = cycle_id;
+        this->entry_positions.at(path.at(j)) = static_cast<types::whole_num>(cycle.size());
+        states.at(path.at(j)) = visited;
+        cycle.push_back(path.at(j));
+      }
+
+      this->cycles.push_back(cycle);
+    }
+
+    for (types::whole_num j{tail_end}; j > 0; j--)
+    {
+      types::short_whole_num tail_config{path.at(j - 1)};
+      types::short_whole_num next_config{graph.at(tail_config)};
+
+      this->tail_lengths.at(tail_config) = this->tail_lengths.at(next_config) + 1;
+      this->cycle_ids.at(tail_config) = this->cycle_ids.at(next_config);
+      this->entry_positions.at(tail_config) = this->entry_positions.at(next_config);
+      states.at(tail_config) = visited;
+    }
+  }
+}
+
+types::whole_num
+models::orbit_index::get_tail_length(types::short_whole_num config) const
+{
+  return this->tail_lengths.at(config);
+}
+
+types::whole_num
+models::orbit_index::get_cycle_length(types::short_whole_num config) const
+{
+  return static_cast<types::whole_num>(this->cycles.at(this->cycle_ids.at(config)).size());
+}
+
+// Tails are shorter than the no. of configurations, so walking one is bounded by the size of the graph.
+// Past the tail, the answer is a single lookup.
+types::short_whole_num
+models::orbit_index::get_future_config(types::short_whole_num config, types::long_whole_num steps) const
+{
+  if (config >= this->graph.size())
+  {
+    throw std::invalid_argument{"Configuration out of range"};
+  }
+
+  types::whole_num tail_length{this->tail_lengths.at(config)};
+
+  if (steps < tail_length)
+  {
+    for (types::long_whole_num i{}; i < steps; i++)
+    {
+      config = this->graph.at(config);
+    }
+
+    return config;
+  }
+
+  const std::vector<types::short_whole_num> &cycle{this->cycles.at(this->cycle_ids.at(config))};
+  return cycle.at((this->entry_positions.at(config) + (steps - tail_length) % cycle.size()) % cycle.size());
+}
@@ -0,0 +1,40 @@
+#ifndef __ORBIT_INDEX__
+#define __ORBIT_INDEX__
+
+#include <vector>
+
+#include "../../types/types.hpp"
+
+namespace models
+{
+  // Locates every configuration of a transition graph relative to the cycle its orbit ends in.
+  //
+  // An orbit walks a tail of some length into a cycle, and then stays on that cycle forever.
+  // So the configuration after t steps is found by walking the tail when t is shorter than it,
+  // and otherwise by reducing the remaining steps modulo the cycle length.
+  class orbit_index
+  {
+    private:
+      types::transition_graph graph{};
+      std::vector<std::vector<types::short_whole_num>> cycles{};
+
+      // The no. of steps to reach a cycle, that cycle, and the position along it where the orbit enters.
+      std::vector<types::whole_num> tail_lengths{};
+      std::vector<types::whole_num> cycle_ids{};
+      std::vector<types::whole_num> entry_positions{};
+
+    public:
+      explicit orbit_index(const types::transition_graph &graph);
+
+      types::whole_num
+      get_tail_length(types::short_whole_num config) const;
+
+      types::whole_num
+      get_cycle_length(types::short_whole_num config) const;
+
+      types::short_whole_num
+      get_future_config(types::short_whole_num config, types::long_whole_num steps) const;
+  };
+}
+
+#endif
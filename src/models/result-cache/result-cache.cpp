@@ -0,0 +1,79 @@
+#include "result-cache.hpp"
+
+#include "../../utils/utils.hpp"
+
+static std::string cache_directory{};
+
+static std::string
+get_file_path(const std::string &key)
+{
+  return cache_directory + "/" + utils::number::to_hex_str(utils::number::get_hash(key), 16) + ".car";
+}
+
+void
+models::result_cache::set_directory(const std::string &path)
+{
+  if (!path.empty())
+  {
+    utils::file::make_directory(path);
+  }
+
+  cache_directory = path;
+}
+
+const std::string &
+models::result_cache::get_directory()
+{
+  return cache_directory;
+}
+
+bool
+models::result_cache::is_enabled()
+{
+  return !cache_directory.empty();
+}
+
+// The version is bumped whenever an analysis changes, so that results computed by an older implementation are ignored.
+std::string
+models::result_cache::get_key(const std::string &subject, const std::string &analysis, types::whole_num version)
+{
+  return subject + ";analysis=" + analysis + ";version=" + std::to_string(version);
+}
+
+bool
+models::result_cache::load(const std::string &key, std::string &value)
+{
+  if (!models::result_cache::is_enabled())
+  {
+    return false;
+  }
+
+  std::string contents{};
+
+  if (!utils::file::read(get_file_path(key), contents))
+  {
+    return false;
+  }
+
+  std::size_t key_end{contents.find('\n')};
+
+  if (key_end == std::string::npos || contents.compare(0, key_end, key) != 0)
+  {
+    return false;
+  }
+
+  value = contents.substr(key_end + 1);
+  return true;
+}
+
+// Storing is best effort, as a cache that can't be written must not fail the analysis.
+void
+models::result_cache::store(const std::string &key, const std::string &value)
+{
+  if (!models::result_cache::is_enabled())
+  {
+    return;
+  }
+
+  utils::file::write_atomically(get_file_path(key), key + "\n" + value);
+}
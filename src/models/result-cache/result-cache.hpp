@@ -0,0 +1,38 @@
+#ifndef __RESULT_CACHE__
+#define __RESULT_CACHE__
+
+#include <string>
+
+#include "../../types/types.hpp"
+
+namespace models
+{
+  // A persistent key-value store for the results of expensive analyses.
+  // Every result is stored in a directory, under a file named by the hash of its key.
+  // A file holds the full key on its first line and the value after it, so that hash collisions read as misses.
+  // Files are replaced atomically, so any number of processes can read and write the same directory.
+  // The cache is disabled until a directory is set.
+  class result_cache
+  {
+    public:
+      static void
+      set_directory(const std::string &path);
+
+      static const std::string &
+      get_directory();
+
+      static bool
+      is_enabled();
+
+      static std::string
+      get_key(const std::string &subject, const std::string &analysis, types::whole_num version);
+
+      static bool
+      load(const std::string &key, std::string &value);
+
+      static void
+      store(const std::string &key, const std::string &value);
+  };
+}
+
+#endif
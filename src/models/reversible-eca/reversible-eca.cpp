@@ -237,8 +237,8 @@ get_last_cell_rule(types::boundary boundary, types::short_whole_num group_index)
   return selected_rules.at(utils::number::get_random_num(0, selected_rules.size() - 1));
 }
 
-models::binary_1d_ca
-models::reversible_eca::get_random(types::short_whole_num size, types::boundary boundary)
+types::rules
+models::reversible_eca::get_random_rules(types::short_whole_num size, types::boundary boundary)
 {
   if (size < 3)
   {
@@ -275,5 +275,11 @@ models::reversible_eca::get_random(types::short_whole_num size, types::boundary
     }
   }
 
-  return models::binary_1d_ca{size, 1, 1, boundary, random_rules};
+  return random_rules;
+}
+
+models::binary_1d_ca
+models::reversible_eca::get_random(types::short_whole_num size, types::boundary boundary)
+{
+  return models::binary_1d_ca{size, 1, 1, boundary, models::reversible_eca::get_random_rules(size, boundary)};
 }
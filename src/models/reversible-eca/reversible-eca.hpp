@@ -11,6 +11,9 @@ namespace models
       reversible_eca() = delete;
       reversible_eca(const reversible_eca &other) = delete;
 
+      static types::rules
+      get_random_rules(types::short_whole_num size, types::boundary boundary);
+
       static models::binary_1d_ca
       get_random(types::short_whole_num size, types::boundary boundary);
   };
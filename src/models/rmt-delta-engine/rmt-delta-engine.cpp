@@ -0,0 +1,235 @@
+#include "rmt-delta-engine.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+// The base graph must be a permutation, so that every configuration lies on exactly one cycle.
+models::rmt_delta_engine::rmt_delta_engine(const models::binary_1d_ca &base_ca)
+{
+  if (!base_ca.is_reversible())
+  {
+    throw std::domain_error{"RMT deltas are only supported for reversible CAs"};
+  }
+
+  this->num_cells = base_ca.get_num_cells();
+  this->l_radius = base_ca.get_l_radius();
+  this->r_radius = base_ca.get_r_radius();
+  this->boundary = base_ca.get_boundary();
+  this->graph = base_ca.get_graph();
+
+  this->cycle_ids.resize(this->graph.size(), 0);
+  this->cycle_positions.resize(this->graph.size(), 0);
+  std::vector<bool> is_visited(this->graph.size(), false);
+
+  for (types::whole_num i{}; i < this->graph.size(); i++)
+  {
+    if (is_visited.at(i))
+    {
+      continue;
+    }
+
+    types::whole_num cycle_id{static_cast<types::whole_num>(this->cycle_sizes.size())};
+    types::whole_num cycle_size{};
+    types::whole_num current_config{i};
+
+    do
+    {
+      is_visited.at(current_config) = true;
+      this->cycle_ids.at(current_config) = cycle_id;
+      this->cycle_positions.at(current_config) = cycle_size++;
+      current_config = this->graph.at(current_config);
+    } while (current_config != i);
+
+    this->cycle_sizes.push_back(cycle_size);
+    this->cycle_spectrum[cycle_size] += 1;
+  }
+}
+
+const std::map<types::whole_num, types::whole_num> &
+models::rmt_delta_engine::get_cycle_spectrum() const
+{
+  return this->cycle_spectrum;
+}
+
+// A configuration matches an RMT when the cells of the neighborhood hold its bits, with the leftmost cell as the most significant bit.
+// The other cells are free, and all their combinations are enumerated.
+// Under a null boundary, an RMT that needs a 1 beyond either end matches no configuration.
+std::vector<types::short_whole_num>
+models::rmt_delta_engine::get_affected_configs(
+  types::short_whole_num cell_num,
+  const std::vector<types::short_whole_num> &rmts
+) const
+{
+  std::vector<types::short_whole_num> affected_configs{};
+  types::short_whole_num num_neighbors{static_cast<types::short_whole_num>(this->l_radius + this->r_radius + 1)};
+  types::whole_num all_cells_mask{static_cast<types::whole_num>(this->graph.size() - 1)};
+
+  for (const auto &rmt : rmts)
+  {
+    types::whole_num fixed_mask{};
+    types::whole_num fixed_value{};
+    bool is_possible{true};
+
+    for (types::short_whole_num j{}; j < num_neighbors; j++)
+    {
+      types::num neighbor_num{cell_num - this->l_radius + j};
+      bool neighbor_state{static_cast<bool>((rmt >> (num_neighbors - 1 - j)) & 1)};
+
+      if (neighbor_num < 0 || neighbor_num >= this->num_cells)
+      {
+        if (this->boundary == types::boundary::null)
+        {
+          is_possible = is_possible && !neighbor_state;
+          continue;
+        }
+
+        neighbor_num = (neighbor_num + this->num_cells) % this->num_cells;
+      }
+
+      types::whole_num cell_bit{1U << (this->num_cells - 1 - neighbor_num)};
+      fixed_mask |= cell_bit;
+      fixed_value |= neighbor_state ? cell_bit : 0;
+    }
+
+    if (!is_possible)
+    {
+      continue;
+    }
+
+    types::whole_num free_mask{all_cells_mask & ~fixed_mask};
+    types::whole_num free_value{};
+
+    do
+    {
+      affected_configs.push_back(static_cast<types::short_whole_num>(fixed_value | free_value));
+      free_value = (free_value - free_mask) & free_mask;
+    } while (free_value != 0);
+  }
+
+  return affected_configs;
+}
+
+types::transition_graph
+models::rmt_delta_engine::get_tweaked_graph(
+  types::short_whole_num cell_num,
+  const std::vector<types::short_whole_num> &rmts
+) const
+{
+  types::transition_graph tweaked_graph{this->graph};
+  types::short_whole_num cell_bit{static_cast<types::short_whole_num>(1U << (this->num_cells - 1 - cell_num))};
+
+  for (const auto &config : this->get_affected_configs(cell_num, rmts))
+  {
+    tweaked_graph.at(config) ^= cell_bit;
+  }
+
+  return tweaked_graph;
+}
+
+// The affected configurations are sorted by their base cycle and position, so that the next one along a cycle is a binary search away.
+// Each one is linked to the next affected configuration reached from its tweaked successor, weighted by the steps in between.
+// The cycles of these links are the cycles of the tweaked graph through affected configurations.
+// A tweaked successor on a base cycle without affected configurations leads into that intact cycle instead.
+models::rmt_delta
+models::rmt_delta_engine::apply(
+  types::short_whole_num cell_num,
+  const std::vector<types::short_whole_num> &rmts
+) const
+{
+  static const types::whole_num no_link{static_cast<types::whole_num>(-1)};
+
+  models::rmt_delta delta{};
+  delta.affected_configs = this->get_affected_configs(cell_num, rmts);
+  delta.cycle_spectrum = this->cycle_spectrum;
+
+  types::short_whole_num cell_bit{static_cast<types::short_whole_num>(1U << (this->num_cells - 1 - cell_num))};
+  std::vector<std::tuple<types::whole_num, types::whole_num, types::short_whole_num>> affected_nodes{};
+
+  for (const auto &config : delta.affected_configs)
+  {
+    affected_nodes.emplace_back(this->cycle_ids.at(config), this->cycle_positions.at(config), config);
+  }
+
+  std::sort(affected_nodes.begin(), affected_nodes.end());
+
+  for (types::whole_num i{}; i < affected_nodes.size(); i++)
+  {
+    if (i == 0 || std::get<0>(affected_nodes.at(i)) != std::get<0>(affected_nodes.at(i - 1)))
+    {
+      types::whole_num cycle_size{this->cycle_sizes.at(std::get<0>(affected_nodes.at(i)))};
+      delta.num_cycles_affected += 1;
+
+      if (--delta.cycle_spectrum[cycle_size] == 0)
+      {
+        delta.cycle_spectrum.erase(cycle_size);
+      }
+    }
+  }
+
+  std::vector<types::whole_num> links(affected_nodes.size(), no_link);
+  std::vector<types::whole_num> weights(affected_nodes.size(), 0);
+
+  for (types::whole_num i{}; i < affected_nodes.size(); i++)
+  {
+    types::short_whole_num next_config{static_cast<types::short_whole_num>(this->graph.at(std::get<2>(affected_nodes.at(i))) ^ cell_bit)};
+    types::whole_num cycle_id{this->cycle_ids.at(next_config)};
+    types::whole_num position{this->cycle_positions.at(next_config)};
+
+    auto cycle_begin{std::lower_bound(affected_nodes.begin(), affected_nodes.end(), std::make_tuple(cycle_id, 0U, static_cast<types::short_whole_num>(0)))};
+    auto cycle_end{std::lower_bound(affected_nodes.begin(), affected_nodes.end(), std::make_tuple(cycle_id + 1, 0U, static_cast<types::short_whole_num>(0)))};
+
+    if (cycle_begin == cycle_end)
+    {
+      continue;
+    }
+
+    auto next_node{std::lower_bound(cycle_begin, cycle_end, std::make_tuple(cycle_id, position, static_cast<types::short_whole_num>(0)))};
+    next_node = next_node == cycle_end ? cycle_begin : next_node;
+
+    types::whole_num cycle_size{this->cycle_sizes.at(cycle_id)};
+    links.at(i) = static_cast<types::whole_num>(next_node - affected_nodes.begin());
+    weights.at(i) = 1 + (std::get<1>(*next_node) + cycle_size - position) % cycle_size;
+  }
+
+  static const types::short_whole_num unvisited{0};
+  static const types::short_whole_num in_progress{1};
+  static const types::short_whole_num visited{2};
+
+  std::vector<types::short_whole_num> states(affected_nodes.size(), unvisited);
+
+  for (types::whole_num i{}; i < affected_nodes.size(); i++)
+  {
+    types::whole_num current_node{i};
+
+    while (current_node != no_link && states.at(current_node) == unvisited)
+    {
+      states.at(current_node) = in_progress;
+      current_node = links.at(current_node);
+    }
+
+    if (current_node != no_link && states.at(current_node) == in_progress)
+    {
+      types::whole_num start_node{current_node};
+      types::whole_num cycle_size{};
+
+      do
+      {
+        cycle_size += weights.at(current_node);
+        current_node = links.at(current_node);
+      } while (current_node != start_node);
+
+      delta.cycle_spectrum[cycle_size] += 1;
+    }
+
+    current_node = i;
+
+    while (current_node != no_link && states.at(current_node) == in_progress)
+    {
+      states.at(current_node) = visited;
+      current_node = links.at(current_node);
+    }
+  }
+
+  return delta;
+}
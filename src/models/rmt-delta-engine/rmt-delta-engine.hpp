@@ -0,0 +1,62 @@
+#ifndef __RMT_DELTA_ENGINE__
+#define __RMT_DELTA_ENGINE__
+
+#include <map>
+#include <vector>
+
+#include "../../types/types.hpp"
+#include "../binary-1d-ca/binary-1d-ca.hpp"
+
+namespace models
+{
+  // The changes made to a transition graph by complementing some RMTs of the rule of one cell.
+  struct rmt_delta
+  {
+    std::vector<types::short_whole_num> affected_configs{};
+    types::whole_num num_cycles_affected{};
+
+    // Maps every cycle length of the tweaked graph to the number of cycles of that length.
+    std::map<types::whole_num, types::whole_num> cycle_spectrum{};
+  };
+
+  // Derives the transition graphs of rule tweaks from the graph of a reversible base CA, without building the tweaked CAs.
+  //
+  // Complementing RMTs of the rule of cell i changes only the configurations whose neighborhood at cell i is one of them.
+  // The successor of each such configuration differs from its base successor in just the bit of cell i.
+  // With k cells in a neighborhood, that is 2^n / 2^k configurations per RMT, which are enumerated directly.
+  //
+  // The cycles of the tweaked graph that avoid the affected configurations are cycles of the base graph.
+  // The rest are found by jumping from one affected configuration to the next along the base cycles.
+  class rmt_delta_engine
+  {
+    private:
+      types::short_whole_num num_cells{};
+      types::short_whole_num l_radius{};
+      types::short_whole_num r_radius{};
+      types::boundary boundary{};
+      types::transition_graph graph{};
+
+      // The base cycle of every configuration, and its position along that cycle.
+      std::vector<types::whole_num> cycle_ids{};
+      std::vector<types::whole_num> cycle_positions{};
+      std::vector<types::whole_num> cycle_sizes{};
+      std::map<types::whole_num, types::whole_num> cycle_spectrum{};
+
+    public:
+      explicit rmt_delta_engine(const models::binary_1d_ca &base_ca);
+
+      const std::map<types::whole_num, types::whole_num> &
+      get_cycle_spectrum() const;
+
+      std::vector<types::short_whole_num>
+      get_affected_configs(types::short_whole_num cell_num, const std::vector<types::short_whole_num> &rmts) const;
+
+      types::transition_graph
+      get_tweaked_graph(types::short_whole_num cell_num, const std::vector<types::short_whole_num> &rmts) const;
+
+      models::rmt_delta
+      apply(types::short_whole_num cell_num, const std::vector<types::short_whole_num> &rmts) const;
+  };
+}
+
+#endif
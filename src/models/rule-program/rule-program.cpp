@@ -0,0 +1,507 @@
+#include "rule-program.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "../../terminal/terminal.hpp"
+#include "../../utils/utils.hpp"
+#include "../binary-1d-ca/binary-1d-ca.hpp"
+
+// Every neighborhood of the rule is checked on the lowest bit, with the neighbors as words of all 0s or all 1s.
+template <types::long_whole_num rule>
+static constexpr bool
+is_formula_of_rule()
+{
+  for (types::whole_num p{}; p < 8; p++)
+  {
+    types::long_whole_num l{(p >> 2) & 1 ? ~0UL : 0};
+    types::long_whole_num c{(p >> 1) & 1 ? ~0UL : 0};
+    types::long_whole_num r{p & 1 ? ~0UL : 0};
+
+    if ((models::eca_formula<rule>::apply(l, c, r) & 1) != ((rule >> p) & 1))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static_assert(is_formula_of_rule<30>() && is_formula_of_rule<45>() && is_formula_of_rule<51>() && is_formula_of_rule<60>());
+static_assert(is_formula_of_rule<90>() && is_formula_of_rule<102>() && is_formula_of_rule<105>() && is_formula_of_rule<110>());
+static_assert(is_formula_of_rule<150>() && is_formula_of_rule<170>() && is_formula_of_rule<184>() && is_formula_of_rule<204>());
+static_assert(is_formula_of_rule<232>() && is_formula_of_rule<240>());
+
+enum split_kind
+{
+  constant,
+  variable,
+  not_variable,
+  and_variable,
+  and_not_variable,
+  or_variable,
+  or_not_variable,
+  xor_variable,
+  davio,
+  mux
+};
+
+// How a function is built from a neighbor x and the halves f0 and f1 of its truth table, for x = 0 and x = 1.
+struct rule_split
+{
+  types::short_whole_num cost{};
+  split_kind kind{};
+  types::short_whole_num variable{};
+  types::long_whole_num f0{};
+  types::long_whole_num f1{};
+};
+
+// Functions are truth tables, where bit p is the next state for neighborhood p.
+// Neighbor k, from the left, is bit (l + r - k) of a neighborhood.
+struct rule_synthesizer
+{
+  types::long_whole_num all_ones{};
+  std::vector<types::long_whole_num> variables{};
+  std::unordered_map<types::long_whole_num, rule_split> splits{};
+
+  std::vector<models::rule_instruction> instructions{};
+  std::unordered_map<types::long_whole_num, types::short_whole_num> registers{};
+
+  rule_synthesizer(types::short_whole_num num_neighbors)
+  {
+    types::whole_num num_neighborhoods{1U << num_neighbors};
+    this->all_ones = num_neighborhoods == 64 ? ~0UL : (1UL << num_neighborhoods) - 1;
+
+    for (types::short_whole_num k{}; k < num_neighbors; k++)
+    {
+      types::long_whole_num variable{};
+
+      for (types::whole_num p{}; p < num_neighborhoods; p++)
+      {
+        variable |= static_cast<types::long_whole_num>((p >> (num_neighbors - 1 - k)) & 1) << p;
+      }
+
+      this->registers.emplace(variable, k);
+      this->variables.push_back(variable);
+    }
+  }
+
+  // The halves are spread back over both values of the neighbor, so they are functions of the same neighborhoods.
+  void
+  get_halves(types::long_whole_num f, types::short_whole_num k, types::long_whole_num &f0, types::long_whole_num &f1) const
+  {
+    types::short_whole_num shift{static_cast<types::short_whole_num>(1U << (this->variables.size() - 1 - k))};
+
+    f0 = f & ~this->variables[k];
+    f0 |= f0 << shift;
+    f1 = f & this->variables[k];
+    f1 |= f1 >> shift;
+  }
+
+  // The cost is the no. of word operations, without counting the subformulas that are shared.
+  const rule_split &
+  get_split(types::long_whole_num f)
+  {
+    auto found{this->splits.find(f)};
+
+    if (found != this->splits.end())
+    {
+      return found->second;
+    }
+
+    rule_split best_split{};
+
+    if (f == 0 || f == this->all_ones)
+    {
+      best_split = {1, split_kind::constant};
+      return this->splits[f] = best_split;
+    }
+
+    for (types::short_whole_num k{}; k < this->variables.size(); k++)
+    {
+      if (f == this->variables[k])
+      {
+        best_split = {0, split_kind::variable, k};
+        return this->splits[f] = best_split;
+      }
+
+      if (f == (~this->variables[k] & this->all_ones))
+      {
+        best_split = {1, split_kind::not_variable, k};
+        return this->splits[f] = best_split;
+      }
+    }
+
+    best_split.cost = USHRT_MAX;
+
+    auto try_split{[&](types::whole_num cost, split_kind kind, types::short_whole_num k, types::long_whole_num f0, types::long_whole_num f1) {
+      if (cost < best_split.cost)
+      {
+        best_split = {static_cast<types::short_whole_num>(cost), kind, k, f0, f1};
+      }
+    }};
+
+    for (types::short_whole_num k{}; k < this->variables.size(); k++)
+    {
+      types::long_whole_num f0{};
+      types::long_whole_num f1{};
+      this->get_halves(f, k, f0, f1);
+
+      if (f0 == f1)
+      {
+        continue;
+      }
+
+      if (f0 == 0)
+      {
+        try_split(1 + this->get_split(f1).cost, split_kind::and_variable, k, f0, f1);
+      }
+      else if (f1 == 0)
+      {
+        try_split(1 + this->get_split(f0).cost, split_kind::and_not_variable, k, f0, f1);
+      }
+      else if (f1 == this->all_ones)
+      {
+        try_split(1 + this->get_split(f0).cost, split_kind::or_variable, k, f0, f1);
+      }
+      else if (f0 == this->all_ones)
+      {
+        try_split(2 + this->get_split(f1).cost, split_kind::or_not_variable, k, f0, f1);
+      }
+      else if ((f0 ^ f1) == this->all_ones)
+      {
+        try_split(1 + this->get_split(f0).cost, split_kind::xor_variable, k, f0, f1);
+      }
+      else
+      {
+        types::whole_num f0_cost{this->get_split(f0).cost};
+        try_split(2 + f0_cost + this->get_split(f0 ^ f1).cost, split_kind::davio, k, f0, f1);
+        try_split(3 + f0_cost + this->get_split(f1).cost, split_kind::mux, k, f0, f1);
+      }
+    }
+
+    return this->splits[f] = best_split;
+  }
+
+  types::short_whole_num
+  add_instruction(models::rule_op op, types::short_whole_num a, types::short_whole_num b, types::long_whole_num f)
+  {
+    auto found{this->registers.find(f)};
+
+    if (found != this->registers.end())
+    {
+      return found->second;
+    }
+
+    types::short_whole_num register_num{static_cast<types::short_whole_num>(this->variables.size() + this->instructions.size())};
+    this->instructions.push_back({op, a, b});
+    this->registers.emplace(f, register_num);
+
+    return register_num;
+  }
+
+  types::short_whole_num
+  emit(types::long_whole_num f)
+  {
+    auto found{this->registers.find(f)};
+
+    if (found != this->registers.end())
+    {
+      return found->second;
+    }
+
+    rule_split split{this->get_split(f)};
+    types::short_whole_num k{split.variable};
+    types::long_whole_num x{this->variables[k]};
+
+    switch (split.kind)
+    {
+      case split_kind::constant:
+        return this->add_instruction(f == 0 ? models::rule_op::zero_op : models::rule_op::ones_op, 0, 0, f);
+
+      case split_kind::variable:
+        return k;
+
+      case split_kind::not_variable:
+        return this->add_instruction(models::rule_op::not_op, k, 0, f);
+
+      case split_kind::and_variable:
+        return this->add_instruction(models::rule_op::and_op, k, this->emit(split.f1), f);
+
+      case split_kind::and_not_variable:
+        return this->add_instruction(models::rule_op::and_not_op, this->emit(split.f0), k, f);
+
+      case split_kind::or_variable:
+        return this->add_instruction(models::rule_op::or_op, k, this->emit(split.f0), f);
+
+      case split_kind::or_not_variable:
+      {
+        types::short_whole_num masked{this->add_instruction(
+          models::rule_op::and_not_op, k, this->emit(split.f1), x & ~split.f1 & this->all_ones
+        )};
+        return this->add_instruction(models::rule_op::not_op, masked, 0, f);
+      }
+
+      case split_kind::xor_variable:
+        return this->add_instruction(models::rule_op::xor_op, k, this->emit(split.f0), f);
+
+      case split_kind::davio:
+      {
+        types::long_whole_num difference{split.f0 ^ split.f1};
+        types::short_whole_num f0_register{this->emit(split.f0)};
+        types::short_whole_num masked{this->add_instruction(models::rule_op::and_op, k, this->emit(difference), x & difference)};
+        return this->add_instruction(models::rule_op::xor_op, f0_register, masked, f);
+      }
+
+      case split_kind::mux:
+      {
+        types::short_whole_num high{this->add_instruction(models::rule_op::and_op, k, this->emit(split.f1), x & split.f1)};
+        types::short_whole_num low{this->add_instruction(models::rule_op::and_not_op, this->emit(split.f0), k, split.f0 & ~x)};
+        return this->add_instruction(models::rule_op::or_op, high, low, f);
+      }
+    }
+
+    return k;
+  }
+};
+
+static std::string
+get_neighbor_name(types::short_whole_num neighbor_num, types::short_whole_num l_radius)
+{
+  if (neighbor_num < l_radius)
+  {
+    return "l" + std::to_string(l_radius - neighbor_num);
+  }
+
+  if (neighbor_num == l_radius)
+  {
+    return "c";
+  }
+
+  return "r" + std::to_string(neighbor_num - l_radius);
+}
+
+std::string
+models::rule_program::get_formula(types::short_whole_num register_num, bool is_nested) const
+{
+  types::short_whole_num num_neighbors{static_cast<types::short_whole_num>(this->l_radius + this->r_radius + 1)};
+
+  if (register_num < num_neighbors)
+  {
+    return get_neighbor_name(register_num, this->l_radius);
+  }
+
+  const models::rule_instruction &instruction{this->instructions.at(register_num - num_neighbors)};
+
+  // A double negation is dropped, rather than printed as ~~x.
+  auto get_negated_formula{[&](types::short_whole_num negated_register) {
+    if (negated_register >= num_neighbors && this->instructions.at(negated_register - num_neighbors).op == models::rule_op::not_op)
+    {
+      return this->get_formula(this->instructions.at(negated_register - num_neighbors).a, true);
+    }
+
+    return "~" + this->get_formula(negated_register, true);
+  }};
+
+  std::string formula{};
+
+  switch (instruction.op)
+  {
+    case models::rule_op::and_op:
+      formula = this->get_formula(instruction.a, true) + " & " + this->get_formula(instruction.b, true);
+      break;
+
+    case models::rule_op::or_op:
+      formula = this->get_formula(instruction.a, true) + " | " + this->get_formula(instruction.b, true);
+      break;
+
+    case models::rule_op::xor_op:
+      formula = this->get_formula(instruction.a, true) + " ^ " + this->get_formula(instruction.b, true);
+      break;
+
+    case models::rule_op::and_not_op:
+      formula = this->get_formula(instruction.a, true) + " & " + get_negated_formula(instruction.b);
+      break;
+
+    case models::rule_op::not_op:
+      return get_negated_formula(instruction.a);
+
+    case models::rule_op::zero_op:
+      return "0";
+
+    case models::rule_op::ones_op:
+      return "1";
+  }
+
+  return is_nested ? "(" + formula + ")" : formula;
+}
+
+// The complement of the rule is tried as well, as it can be cheaper by more than the final NOT.
+models::rule_program::rule_program(
+  types::long_whole_num rule,
+  types::short_whole_num l_radius,
+  types::short_whole_num r_radius
+)
+{
+  if (l_radius > models::binary_1d_ca::max_l_radius || r_radius > models::binary_1d_ca::max_r_radius)
+  {
+    throw std::invalid_argument{"Unsupported radius"};
+  }
+
+  types::short_whole_num num_neighbors{static_cast<types::short_whole_num>(l_radius + r_radius + 1)};
+
+  if (num_neighbors > models::binary_1d_ca::max_num_neighbors)
+  {
+    throw std::invalid_argument{"Unsupported neighborhood size"};
+  }
+
+  if (num_neighbors < 6 && rule >= (1UL << (1U << num_neighbors)))
+  {
+    throw std::invalid_argument{"Invalid rule: " + std::to_string(rule)};
+  }
+
+  this->l_radius = l_radius;
+  this->r_radius = r_radius;
+
+  rule_synthesizer synthesizer{num_neighbors};
+  types::long_whole_num complement{~rule & synthesizer.all_ones};
+
+  if (synthesizer.get_split(complement).cost + 1 < synthesizer.get_split(rule).cost)
+  {
+    this->output = synthesizer.add_instruction(models::rule_op::not_op, synthesizer.emit(complement), 0, rule);
+  }
+  else
+  {
+    this->output = synthesizer.emit(rule);
+  }
+
+  this->instructions = synthesizer.instructions;
+}
+
+types::short_whole_num
+models::rule_program::get_num_ops() const
+{
+  return static_cast<types::short_whole_num>(this->instructions.size());
+}
+
+types::short_whole_num
+models::rule_program::get_num_registers() const
+{
+  return static_cast<types::short_whole_num>(this->l_radius + this->r_radius + 1 + this->instructions.size());
+}
+
+types::short_whole_num
+models::rule_program::get_output() const
+{
+  return this->output;
+}
+
+const std::vector<models::rule_instruction> &
+models::rule_program::get_instructions() const
+{
+  return this->instructions;
+}
+
+std::string
+models::rule_program::get_formula() const
+{
+  return this->get_formula(this->output, false);
+}
+
+types::long_whole_num
+models::rule_program::evaluate(std::vector<types::long_whole_num> &registers) const
+{
+  types::long_whole_num *next_register{registers.data() + this->l_radius + this->r_radius + 1};
+
+  for (const auto &instruction : this->instructions)
+  {
+    types::long_whole_num a{registers[instruction.a]};
+    types::long_whole_num b{registers[instruction.b]};
+
+    switch (instruction.op)
+    {
+      case models::rule_op::and_op:
+        *next_register = a & b;
+        break;
+
+      case models::rule_op::or_op:
+        *next_register = a | b;
+        break;
+
+      case models::rule_op::xor_op:
+        *next_register = a ^ b;
+        break;
+
+      case models::rule_op::and_not_op:
+        *next_register = a & ~b;
+        break;
+
+      case models::rule_op::not_op:
+        *next_register = ~a;
+        break;
+
+      case models::rule_op::zero_op:
+        *next_register = 0;
+        break;
+
+      case models::rule_op::ones_op:
+        *next_register = ~0UL;
+        break;
+    }
+
+    next_register++;
+  }
+
+  return registers[this->output];
+}
+
+void
+models::rule_program::print_formulas(types::short_whole_num l_radius, types::short_whole_num r_radius, const types::rules &rules)
+{
+  std::vector<std::pair<types::long_whole_num, models::rule_program>> programs{};
+
+  for (const auto &rule : rules)
+  {
+    bool is_duplicate{std::any_of(programs.begin(), programs.end(), [&](const auto &program) {
+      return program.first == rule;
+    })};
+
+    if (!is_duplicate)
+    {
+      programs.emplace_back(rule, models::rule_program{rule, l_radius, r_radius});
+    }
+  }
+
+  types::short_whole_num formula_width{7};
+
+  for (const auto &program : programs)
+  {
+    formula_width = std::max(formula_width, static_cast<types::short_whole_num>(program.second.get_formula().size()));
+  }
+
+  std::vector<std::pair<std::string, types::short_whole_num>> headings{
+    std::make_pair<std::string, types::short_whole_num>("Rule", 20),
+    std::make_pair<std::string, types::short_whole_num>("Formula", static_cast<types::short_whole_num>(formula_width)),
+    std::make_pair<std::string, types::short_whole_num>("Ops", 3)
+  };
+
+  utils::general::print_header(headings, {
+    output::field_type::number,
+    output::field_type::text,
+    output::field_type::number
+  });
+
+  for (const auto &program : programs)
+  {
+    std::vector<std::pair<std::string, types::short_whole_num>> entries{
+      std::make_pair<std::string, types::short_whole_num>(std::to_string(program.first), 20),
+      std::make_pair<std::string, types::short_whole_num>(program.second.get_formula(), static_cast<types::short_whole_num>(formula_width)),
+      std::make_pair<std::string, types::short_whole_num>(std::to_string(program.second.get_num_ops()), 3)
+    };
+
+    utils::general::print_row(entries);
+  }
+}
@@ -0,0 +1,220 @@
+#ifndef __RULE_PROGRAM__
+#define __RULE_PROGRAM__
+
+#include <string>
+#include <vector>
+
+#include "../../types/types.hpp"
+
+namespace models
+{
+  enum rule_op
+  {
+    and_op,
+    or_op,
+    xor_op,
+    and_not_op,
+    not_op,
+    zero_op,
+    ones_op
+  };
+
+  // Writes `a op b` to the next register, where `and_not_op` is `a & ~b`, and `not_op` only reads `a`.
+  struct rule_instruction
+  {
+    models::rule_op op{};
+    types::short_whole_num a{};
+    types::short_whole_num b{};
+  };
+
+  // A rule compiled into a straight line program of word operations, which computes the next states of 64 cells at once.
+  // The first l + r + 1 registers are the words of the neighbors, leftmost first, and every instruction adds a register.
+  //
+  // The formula is synthesized by splitting the rule on one neighbor at a time, and keeping the cheapest split.
+  //   - Where a half is constant, or the halves are complements, the neighbor is ANDed, ORed or XORed with the other half.
+  //   - Otherwise the halves are recombined as f0 ^ (x & (f0 ^ f1)), or as (x & f1) | (f0 & ~x).
+  // Subformulas are identified by their truth tables, so every one of them is computed once.
+  class rule_program
+  {
+    private:
+      types::short_whole_num l_radius{};
+      types::short_whole_num r_radius{};
+      types::short_whole_num output{};
+      std::vector<models::rule_instruction> instructions{};
+
+      std::string
+      get_formula(types::short_whole_num register_num, bool is_nested) const;
+
+    public:
+      rule_program(types::long_whole_num rule, types::short_whole_num l_radius, types::short_whole_num r_radius);
+
+      types::short_whole_num
+      get_num_ops() const;
+
+      types::short_whole_num
+      get_num_registers() const;
+
+      types::short_whole_num
+      get_output() const;
+
+      const std::vector<models::rule_instruction> &
+      get_instructions() const;
+
+      std::string
+      get_formula() const;
+
+      // The words of the neighbors are read from the first registers, which must hold at least `get_num_registers()` words.
+      types::long_whole_num
+      evaluate(std::vector<types::long_whole_num> &registers) const;
+
+      static void
+      print_formulas(types::short_whole_num l_radius, types::short_whole_num r_radius, const types::rules &rules);
+  };
+
+  // Hand written formulas of common ECAs, over the words of the left neighbors, the cells and the right neighbors.
+  // They are checked against their rules at compile time.
+  template <types::long_whole_num rule>
+  struct eca_formula;
+
+  template <>
+  struct eca_formula<30>
+  {
+    static constexpr types::long_whole_num
+    apply(types::long_whole_num l, types::long_whole_num c, types::long_whole_num r)
+    {
+      return l ^ (c | r);
+    }
+  };
+
+  template <>
+  struct eca_formula<45>
+  {
+    static constexpr types::long_whole_num
+    apply(types::long_whole_num l, types::long_whole_num c, types::long_whole_num r)
+    {
+      return l ^ (c | ~r);
+    }
+  };
+
+  template <>
+  struct eca_formula<51>
+  {
+    static constexpr types::long_whole_num
+    apply(types::long_whole_num, types::long_whole_num c, types::long_whole_num)
+    {
+      return ~c;
+    }
+  };
+
+  template <>
+  struct eca_formula<60>
+  {
+    static constexpr types::long_whole_num
+    apply(types::long_whole_num l, types::long_whole_num c, types::long_whole_num)
+    {
+      return l ^ c;
+    }
+  };
+
+  template <>
+  struct eca_formula<90>
+  {
+    static constexpr types::long_whole_num
+    apply(types::long_whole_num l, types::long_whole_num, types::long_whole_num r)
+    {
+      return l ^ r;
+    }
+  };
+
+  template <>
+  struct eca_formula<102>
+  {
+    static constexpr types::long_whole_num
+    apply(types::long_whole_num, types::long_whole_num c, types::long_whole_num r)
+    {
+      return c ^ r;
+    }
+  };
+
+  template <>
+  struct eca_formula<105>
+  {
+    static constexpr types::long_whole_num
+    apply(types::long_whole_num l, types::long_whole_num c, types::long_whole_num r)
+    {
+      return ~(l ^ c ^ r);
+    }
+  };
+
+  template <>
+  struct eca_formula<110>
+  {
+    static constexpr types::long_whole_num
+    apply(types::long_whole_num l, types::long_whole_num c, types::long_whole_num r)
+    {
+      return (c ^ r) | (c & ~l);
+    }
+  };
+
+  template <>
+  struct eca_formula<150>
+  {
+    static constexpr types::long_whole_num
+    apply(types::long_whole_num l, types::long_whole_num c, types::long_whole_num r)
+    {
+      return l ^ c ^ r;
+    }
+  };
+
+  template <>
+  struct eca_formula<170>
+  {
+    static constexpr types::long_whole_num
+    apply(types::long_whole_num, types::long_whole_num, types::long_whole_num r)
+    {
+      return r;
+    }
+  };
+
+  template <>
+  struct eca_formula<184>
+  {
+    static constexpr types::long_whole_num
+    apply(types::long_whole_num l, types::long_whole_num c, types::long_whole_num r)
+    {
+      return (l & ~c) | (c & r);
+    }
+  };
+
+  template <>
+  struct eca_formula<204>
+  {
+    static constexpr types::long_whole_num
+    apply(types::long_whole_num, types::long_whole_num c, types::long_whole_num)
+    {
+      return c;
+    }
+  };
+
+  template <>
+  struct eca_formula<232>
+  {
+    static constexpr types::long_whole_num
+    apply(types::long_whole_num l, types::long_whole_num c, types::long_whole_num r)
+    {
+      return (l & c) | (r & (l | c));
+    }
+  };
+
+  template <>
+  struct eca_formula<240>
+  {
+    static constexpr types::long_whole_num
+    apply(types::long_whole_num l, types::long_whole_num, types::long_whole_num)
+    {
+      return l;
+    }
+  };
+}
+
+#endif
@@ -9,6 +9,7 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include "../../instrument/instrument.hpp"
 #include "../../utils/utils.hpp"
 #include "../binary-1d-ca-manager/binary-1d-ca-manager.hpp"
 #include "../binary-1d-ca/binary-1d-ca.hpp"
@@ -64,6 +65,8 @@ is_complementable_polynomial(const types::polynomial &coeffs)
 static std::vector<std::pair<models::rule_vector, types::polynomial>>
 get_complementable_rule_vectors(types::short_whole_num size, types::boundary boundary)
 {
+  CA_SCOPED_TIMER(complementable_rule_vectors);
+
   std::vector<std::pair<models::rule_vector, types::polynomial>> result{};
 
   types::whole_num max_rule_vectors{static_cast<types::whole_num>(
@@ -79,6 +82,7 @@ get_complementable_rule_vectors(types::short_whole_num size, types::boundary bou
     #pragma omp for
     for (types::whole_num i = 0; i < max_rule_vectors; i++)
     {
+      CA_TRACE_CHUNK("complementable_rule_vectors", i);
       std::string current_mask{utils::number::to_string(i, linear_rules.size(), size)};
 
       for (types::short_whole_num j{}; j < size; j++)
@@ -91,8 +95,11 @@ get_complementable_rule_vectors(types::short_whole_num size, types::boundary bou
 
       if (is_complementable_polynomial(current_coeffs))
       {
+        CA_TRACE_LOCK_REQUEST(complementable_critical);
+
         #pragma omp critical
         {
+          CA_TRACE_LOCK_ACQUIRED(complementable_critical);
           result.push_back(std::make_pair<models::rule_vector &, types::polynomial &>(
             current_rule_vector,
             current_coeffs
@@ -122,10 +129,19 @@ models::rule_vector::is_additive() const
 void
 models::rule_vector::print_complementable_rule_vectors()
 {
-  bool header_printed{};
-  types::whole_num counter{};
   types::short_whole_num num_cells{models::binary_1d_ca_manager::read_num_cells()};
   types::boundary boundary{models::binary_1d_ca_manager::read_boundary()};
+  models::rule_vector::print_complementable_rule_vectors(num_cells, boundary);
+}
+
+void
+models::rule_vector::print_complementable_rule_vectors(
+  types::short_whole_num num_cells,
+  types::boundary boundary
+)
+{
+  bool header_printed{};
+  types::whole_num counter{};
 
   std::vector<std::pair<models::rule_vector, types::polynomial>> result{
     get_complementable_rule_vectors(num_cells, boundary)
@@ -150,7 +166,11 @@ models::rule_vector::print_complementable_rule_vectors()
 
     if (!header_printed)
     {
-      utils::general::print_header(headings);
+      utils::general::print_header(headings, {
+        output::field_type::number,
+        output::field_type::number_list,
+        output::field_type::text
+      });
       header_printed = true;
     }
 
@@ -205,6 +225,32 @@ models::rule_vector::is_complementable(types::boundary boundary) const
   return is_complementable_polynomial(coeffs);
 }
 
+// This method works only for ECAs with additive rules.
+// Let T be the characteristic matrix, so that the ECA maps x to Tx + b, where b marks the complemented additive rules.
+// Complementing the cells in c gives the map x -> Tx + b + c.
+// Translating by v conjugates the two maps whenever (T + I)v = c, as then the ECA maps x to y if and only if the complement maps x + v to y + v.
+// Bit i of `complemented_cells` and of `translation` correspond to cell i.
+// A missing translation doesn't rule out the other isomorphisms.
+bool
+models::rule_vector::find_complement_translation(
+  types::boundary boundary,
+  types::long_whole_num complemented_cells,
+  types::long_whole_num &translation
+) const
+{
+  types::matrix M{utils::matrix::add(
+    this->get_characteristic_matrix(boundary),
+    utils::matrix::get_identity(static_cast<types::short_whole_num>(this->size()))
+  )};
+
+  return utils::gf2::solve(
+    utils::gf2::pack(M),
+    static_cast<types::short_whole_num>(this->size()),
+    complemented_cells,
+    translation
+  );
+}
+
 const types::rules &
 models::rule_vector::get_rules() const
 {
@@ -292,6 +338,41 @@ models::rule_vector::get_charactersitic_polynomial(types::boundary boundary) con
   return coeffs;
 }
 
+// This method works only for ECAs with additive rules.
+// The ECA maps x to Tx + b, where b marks the complemented additive rules, as they are 1 on the all-zero neighborhood.
+// Appending a constant 1 to x makes this the linear map of the augmented matrix [T b; 0 1].
+// So t steps are a single product with the t-th power of that matrix, found in O(log t) multiplications.
+// Bit i of `config` and of the result correspond to cell i.
+types::long_whole_num
+models::rule_vector::get_future_config(
+  types::boundary boundary,
+  types::long_whole_num config,
+  types::long_whole_num steps
+) const
+{
+  types::short_whole_num size{static_cast<types::short_whole_num>(this->size())};
+
+  // The augmented matrix must fit into 64 columns.
+  if (size >= 64)
+  {
+    throw std::invalid_argument{"Jumps are only supported for rule vectors of up to 63 cells"};
+  }
+
+  std::vector<types::long_whole_num> M{utils::gf2::pack(this->get_characteristic_matrix(boundary))};
+
+  for (types::short_whole_num i{}; i < size; i++)
+  {
+    M.at(i) |= (this->rules.at(i) & 1) << size;
+  }
+
+  M.push_back(1UL << size);
+
+  types::long_whole_num all_cells_mask{(1UL << size) - 1};
+  types::long_whole_num future_config{utils::gf2::apply(utils::gf2::power(M, steps), (config & all_cells_mask) | (1UL << size))};
+
+  return future_config & all_cells_mask;
+}
+
 std::string
 models::rule_vector::to_string() const
 {
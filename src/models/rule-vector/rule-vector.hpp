@@ -12,20 +12,30 @@ namespace models
     private:
       types::rules rules{};
 
-      bool
-      is_additive() const;
-
     public:
       static void
       print_complementable_rule_vectors();
 
+      static void
+      print_complementable_rule_vectors(types::short_whole_num num_cells, types::boundary boundary);
+
       rule_vector();
 
       rule_vector(const types::rules &rules);
 
+      bool
+      is_additive() const;
+
       bool
       is_complementable(types::boundary boundary) const;
 
+      bool
+      find_complement_translation(
+        types::boundary boundary,
+        types::long_whole_num complemented_cells,
+        types::long_whole_num &translation
+      ) const;
+
       const types::rules &
       get_rules() const;
 
@@ -44,6 +54,13 @@ namespace models
       types::polynomial
       get_charactersitic_polynomial(types::boundary boundary) const;
 
+      types::long_whole_num
+      get_future_config(
+        types::boundary boundary,
+        types::long_whole_num config,
+        types::long_whole_num steps
+      ) const;
+
       std::string
       to_string() const;
   };
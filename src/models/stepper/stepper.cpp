@@ -0,0 +1,592 @@
+#include "stepper.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "../../instrument/instrument.hpp"
+#include "../binary-1d-ca/binary-1d-ca.hpp"
+
+static const types::short_whole_num word_size{64};
+
+using table_ptr = std::shared_ptr<const std::vector<types::short_whole_num>>;
+
+// The tables depend only on the radii and on the rules of a window, so steppers with the same windows share them.
+// The cache is kept in order of use, the most recent first, and the least recently used tables are evicted beyond the budget.
+static std::mutex table_cache_mutex{};
+static std::list<std::pair<std::string, table_ptr>> table_cache{};
+static std::unordered_map<std::string, std::list<std::pair<std::string, table_ptr>>::iterator> table_cache_index{};
+static types::long_whole_num table_cache_bytes{};
+
+static types::long_whole_num
+get_table_bytes(types::short_whole_num l_radius, types::short_whole_num r_radius, types::short_whole_num window_size)
+{
+  return (1UL << (window_size + l_radius + r_radius)) * sizeof(types::short_whole_num);
+}
+
+static types::long_whole_num
+get_low_mask(types::short_whole_num count)
+{
+  return count >= word_size ? ~0UL : (1UL << count) - 1;
+}
+
+// Reverses the order of the low `num_bits` bits, as the leftmost cell of a neighborhood is its most significant bit.
+static types::whole_num
+reverse_bits(types::whole_num bits, types::short_whole_num num_bits)
+{
+  types::whole_num reversed_bits{};
+
+  for (types::short_whole_num i{}; i < num_bits; i++)
+  {
+    reversed_bits |= ((bits >> i) & 1) << (num_bits - 1 - i);
+  }
+
+  return reversed_bits;
+}
+
+// Bit i of an entry is the next state of cell i of the window, whose neighborhood is input bits i to (i + l + r).
+static table_ptr
+build_table(
+  types::short_whole_num l_radius,
+  types::short_whole_num r_radius,
+  types::short_whole_num window_size,
+  const types::rules &window_rules
+)
+{
+  types::short_whole_num num_neighbors{static_cast<types::short_whole_num>(l_radius + r_radius + 1)};
+  types::short_whole_num num_inputs{static_cast<types::short_whole_num>(window_size + l_radius + r_radius)};
+  types::whole_num num_neighborhoods{1U << num_neighbors};
+
+  // next_states[i][v] is the next state of cell i when its neighbors, leftmost first, are the bits of v from the lowest.
+  std::vector<std::vector<types::short_whole_num>> next_states(window_size, std::vector<types::short_whole_num>(num_neighborhoods));
+
+  for (types::short_whole_num i{}; i < window_size; i++)
+  {
+    for (types::whole_num v{}; v < num_neighborhoods; v++)
+    {
+      next_states[i][v] = static_cast<types::short_whole_num>((window_rules.at(i) >> reverse_bits(v, num_neighbors)) & 1);
+    }
+  }
+
+  auto table{std::make_shared<std::vector<types::short_whole_num>>(1UL << num_inputs)};
+
+  for (types::whole_num input{}; input < table->size(); input++)
+  {
+    types::short_whole_num output{};
+
+    for (types::short_whole_num i{}; i < window_size; i++)
+    {
+      output |= next_states[i][(input >> i) & (num_neighborhoods - 1)] << i;
+    }
+
+    (*table)[input] = output;
+  }
+
+  return table;
+}
+
+static table_ptr
+get_table(
+  types::short_whole_num l_radius,
+  types::short_whole_num r_radius,
+  types::short_whole_num window_size,
+  const types::rules &window_rules
+)
+{
+  std::ostringstream key_stream{};
+  key_stream << l_radius << "," << r_radius << "," << window_size << "|";
+
+  for (const auto &rule : window_rules)
+  {
+    key_stream << rule << ",";
+  }
+
+  std::lock_guard<std::mutex> lock{table_cache_mutex};
+  auto found{table_cache_index.find(key_stream.str())};
+
+  if (found != table_cache_index.end())
+  {
+    CA_COUNT(stepper_table_hits, 1);
+    table_cache.splice(table_cache.begin(), table_cache, found->second);
+    return found->second->second;
+  }
+
+  CA_COUNT(stepper_table_misses, 1);
+  CA_SCOPED_TIMER(stepper_build_table);
+
+  table_ptr table{build_table(l_radius, r_radius, window_size, window_rules)};
+  table_cache.emplace_front(key_stream.str(), table);
+  table_cache_index.emplace(key_stream.str(), table_cache.begin());
+  table_cache_bytes += get_table_bytes(l_radius, r_radius, window_size);
+
+  // Steppers keep their own references, so evicting a table only frees it once no stepper uses it.
+  while (table_cache_bytes > models::stepper::max_table_bytes && table_cache.size() > 1)
+  {
+    const auto &oldest{table_cache.back()};
+    table_cache_bytes -= oldest.second->size() * sizeof(types::short_whole_num);
+    table_cache_index.erase(oldest.first);
+    table_cache.pop_back();
+  }
+
+  return table;
+}
+
+// Cells outside the lattice wrap around for periodic boundaries, and are 0 for null boundaries.
+bool
+models::stepper::get_cell(const std::vector<types::long_whole_num> &config, types::long_num cell_num) const
+{
+  types::long_num num_cells{static_cast<types::long_num>(this->num_cells)};
+
+  if (cell_num < 0 || cell_num >= num_cells)
+  {
+    if (this->boundary == types::boundary::null)
+    {
+      return false;
+    }
+
+    cell_num = ((cell_num % num_cells) + num_cells) % num_cells;
+  }
+
+  return (config[cell_num / word_size] >> (cell_num % word_size)) & 1;
+}
+
+// Word 0 holds cells -64 to -1, so cell i is bit (i + 64) of the buffer.
+// Only the l cells before the lattice and the r cells after it are filled in, the rest of the padding is 0.
+void
+models::stepper::fill_padded_words(const std::vector<types::long_whole_num> &config) const
+{
+  types::long_whole_num num_words{this->get_num_words()};
+
+  this->padded_words.assign(num_words + 2, 0);
+  std::copy(config.begin(), config.begin() + num_words, this->padded_words.begin() + 1);
+  this->padded_words[num_words] &= get_low_mask(static_cast<types::short_whole_num>(this->num_cells - (num_words - 1) * word_size));
+
+  for (types::short_whole_num l{1}; l <= this->l_radius; l++)
+  {
+    this->padded_words[0] |= static_cast<types::long_whole_num>(this->get_cell(config, -static_cast<types::long_num>(l))) << (word_size - l);
+  }
+
+  for (types::short_whole_num r{}; r < this->r_radius; r++)
+  {
+    types::long_whole_num bit_num{word_size + this->num_cells + r};
+    this->padded_words[bit_num / word_size] |= static_cast<types::long_whole_num>(
+      this->get_cell(config, static_cast<types::long_num>(this->num_cells + r))
+    ) << (bit_num % word_size);
+  }
+}
+
+// Cells start to (start + count - 1) of the padded buffer, with count at most 64.
+types::long_whole_num
+models::stepper::get_padded_bits(types::long_num start, types::short_whole_num count) const
+{
+  types::long_whole_num bit_num{static_cast<types::long_whole_num>(start + word_size)};
+  types::long_whole_num word_num{bit_num / word_size};
+  types::short_whole_num shift{static_cast<types::short_whole_num>(bit_num % word_size)};
+  types::long_whole_num bits{this->padded_words[word_num] >> shift};
+
+  if (shift != 0 && word_num + 1 < this->padded_words.size())
+  {
+    bits |= this->padded_words[word_num + 1] << (word_size - shift);
+  }
+
+  return bits & get_low_mask(count);
+}
+
+void
+models::stepper::fill_rule_masks()
+{
+  types::whole_num num_neighborhoods{1U << (this->l_radius + this->r_radius + 1)};
+  this->rule_masks.assign(num_neighborhoods, std::vector<types::long_whole_num>(this->get_num_words()));
+
+  for (types::long_whole_num i{}; i < this->num_cells; i++)
+  {
+    types::long_whole_num rule{this->rules[i % this->rules.size()]};
+
+    for (types::whole_num p{}; p < num_neighborhoods; p++)
+    {
+      this->rule_masks[p][i / word_size] |= ((rule >> p) & 1) << (i % word_size);
+    }
+  }
+}
+
+// Hybrid rules whose period doesn't divide the window size need a table for almost every window.
+// So the stepper is refused when its distinct tables would take more than the budget.
+void
+models::stepper::fill_tables()
+{
+  types::long_whole_num num_windows{(this->num_cells + this->window_size - 1) / this->window_size};
+  types::long_whole_num table_bytes{get_table_bytes(this->l_radius, this->r_radius, this->window_size)};
+  std::map<types::rules, table_ptr> window_tables{};
+  this->tables.resize(num_windows);
+
+  for (types::long_whole_num k{}; k < num_windows; k++)
+  {
+    types::rules window_rules(this->window_size);
+
+    // Cells past the end of the lattice are computed and then masked off, so any rule will do for them.
+    for (types::short_whole_num i{}; i < this->window_size; i++)
+    {
+      window_rules[i] = this->rules[(k * this->window_size + i) % this->num_cells % this->rules.size()];
+    }
+
+    auto found{window_tables.find(window_rules)};
+
+    if (found == window_tables.end())
+    {
+      if ((window_tables.size() + 1) * table_bytes > models::stepper::max_table_bytes)
+      {
+        throw std::invalid_argument{"The lookup tables of the rules would take more than " + std::to_string(models::stepper::max_table_bytes >> 20) + " MB"};
+      }
+
+      found = window_tables.emplace(window_rules, get_table(this->l_radius, this->r_radius, this->window_size, window_rules)).first;
+    }
+
+    this->tables[k] = found->second;
+  }
+}
+
+// Rules are compiled once each, however many cells follow them.
+void
+models::stepper::fill_programs()
+{
+  bool is_uniform{std::adjacent_find(this->rules.begin(), this->rules.end(), std::not_equal_to<types::long_whole_num>{}) == this->rules.end()};
+
+  if (is_uniform && this->l_radius == 1 && this->r_radius == 1)
+  {
+    switch (this->rules.at(0))
+    {
+      case 30: this->formula_step = &models::stepper::step_formula<30>; return;
+      case 45: this->formula_step = &models::stepper::step_formula<45>; return;
+      case 51: this->formula_step = &models::stepper::step_formula<51>; return;
+      case 60: this->formula_step = &models::stepper::step_formula<60>; return;
+      case 90: this->formula_step = &models::stepper::step_formula<90>; return;
+      case 102: this->formula_step = &models::stepper::step_formula<102>; return;
+      case 105: this->formula_step = &models::stepper::step_formula<105>; return;
+      case 110: this->formula_step = &models::stepper::step_formula<110>; return;
+      case 150: this->formula_step = &models::stepper::step_formula<150>; return;
+      case 170: this->formula_step = &models::stepper::step_formula<170>; return;
+      case 184: this->formula_step = &models::stepper::step_formula<184>; return;
+      case 204: this->formula_step = &models::stepper::step_formula<204>; return;
+      case 232: this->formula_step = &models::stepper::step_formula<232>; return;
+      case 240: this->formula_step = &models::stepper::step_formula<240>; return;
+    }
+  }
+
+  std::map<types::long_whole_num, types::short_whole_num> program_nums{};
+  types::short_whole_num num_registers{};
+
+  for (const auto &rule : this->rules)
+  {
+    if (program_nums.emplace(rule, this->programs.size()).second)
+    {
+      this->programs.emplace_back(rule, this->l_radius, this->r_radius);
+      num_registers = std::max(num_registers, this->programs.back().get_num_registers());
+    }
+  }
+
+  this->registers.resize(num_registers);
+  this->word_programs.resize(this->get_num_words());
+
+  for (types::long_whole_num j{}; j < this->get_num_words(); j++)
+  {
+    std::map<types::short_whole_num, types::long_whole_num> cell_masks{};
+
+    for (types::long_whole_num i{j * word_size}; i < std::min(this->num_cells, (j + 1) * word_size); i++)
+    {
+      cell_masks[program_nums.at(this->rules[i % this->rules.size()])] |= 1UL << (i % word_size);
+    }
+
+    this->word_programs[j].assign(cell_masks.begin(), cell_masks.end());
+  }
+}
+
+void
+models::stepper::step_scalar(const std::vector<types::long_whole_num> &config, std::vector<types::long_whole_num> &next_config) const
+{
+  for (types::long_whole_num i{}; i < this->num_cells; i++)
+  {
+    types::whole_num neighborhood{};
+
+    for (types::long_num j{-static_cast<types::long_num>(this->l_radius)}; j <= this->r_radius; j++)
+    {
+      neighborhood = (neighborhood << 1) | this->get_cell(config, static_cast<types::long_num>(i) + j);
+    }
+
+    next_config[i / word_size] |= ((this->rules[i % this->rules.size()] >> neighborhood) & 1) << (i % word_size);
+  }
+}
+
+// Every neighborhood p is matched against 64 cells at once, by ANDing the neighbor words or their complements.
+void
+models::stepper::step_bitsliced(const std::vector<types::long_whole_num> &config, std::vector<types::long_whole_num> &next_config) const
+{
+  this->fill_padded_words(config);
+
+  types::short_whole_num num_neighbors{static_cast<types::short_whole_num>(this->l_radius + this->r_radius + 1)};
+  types::whole_num num_neighborhoods{1U << num_neighbors};
+  types::long_whole_num neighbors[binary_1d_ca::max_l_radius + binary_1d_ca::max_r_radius + 1]{};
+
+  for (types::long_whole_num j{}; j < this->get_num_words(); j++)
+  {
+    for (types::short_whole_num k{}; k < num_neighbors; k++)
+    {
+      neighbors[k] = this->get_padded_bits(static_cast<types::long_num>(j * word_size + k) - this->l_radius, word_size);
+    }
+
+    types::long_whole_num next_word{};
+
+    for (types::whole_num p{}; p < num_neighborhoods; p++)
+    {
+      types::long_whole_num rule_mask{this->rule_masks[p][j]};
+
+      if (rule_mask == 0)
+      {
+        continue;
+      }
+
+      types::long_whole_num matches{rule_mask};
+
+      for (types::short_whole_num k{}; k < num_neighbors; k++)
+      {
+        matches &= ((p >> (num_neighbors - 1 - k)) & 1) ? neighbors[k] : ~neighbors[k];
+      }
+
+      next_word |= matches;
+    }
+
+    next_config[j] = next_word;
+  }
+}
+
+// The window size divides 64, so the outputs of a window never straddle two words.
+void
+models::stepper::step_lookup(const std::vector<types::long_whole_num> &config, std::vector<types::long_whole_num> &next_config) const
+{
+  this->fill_padded_words(config);
+
+  types::short_whole_num num_inputs{static_cast<types::short_whole_num>(this->window_size + this->l_radius + this->r_radius)};
+
+  for (types::long_whole_num k{}; k < this->tables.size(); k++)
+  {
+    types::long_whole_num first_cell{k * this->window_size};
+    types::long_whole_num inputs{this->get_padded_bits(static_cast<types::long_num>(first_cell) - this->l_radius, num_inputs)};
+    types::long_whole_num outputs{(*this->tables[k])[inputs]};
+
+    next_config[first_cell / word_size] |= outputs << (first_cell % word_size);
+  }
+}
+
+void
+models::stepper::step_compiled(const std::vector<types::long_whole_num> &config, std::vector<types::long_whole_num> &next_config) const
+{
+  if (this->formula_step != nullptr)
+  {
+    (this->*formula_step)(config, next_config);
+    return;
+  }
+
+  this->fill_padded_words(config);
+
+  types::short_whole_num num_neighbors{static_cast<types::short_whole_num>(this->l_radius + this->r_radius + 1)};
+
+  for (types::long_whole_num j{}; j < this->get_num_words(); j++)
+  {
+    for (types::short_whole_num k{}; k < num_neighbors; k++)
+    {
+      this->registers[k] = this->get_padded_bits(static_cast<types::long_num>(j * word_size + k) - this->l_radius, word_size);
+    }
+
+    types::long_whole_num next_word{};
+
+    for (const auto &word_program : this->word_programs[j])
+    {
+      next_word |= this->programs[word_program.first].evaluate(this->registers) & word_program.second;
+    }
+
+    next_config[j] = next_word;
+  }
+}
+
+template <types::long_whole_num rule>
+void
+models::stepper::step_formula(const std::vector<types::long_whole_num> &config, std::vector<types::long_whole_num> &next_config) const
+{
+  this->fill_padded_words(config);
+
+  for (types::long_whole_num j{}; j < this->get_num_words(); j++)
+  {
+    types::long_num first_cell{static_cast<types::long_num>(j * word_size)};
+
+    next_config[j] = models::eca_formula<rule>::apply(
+      this->get_padded_bits(first_cell - 1, word_size),
+      this->padded_words[j + 1],
+      this->get_padded_bits(first_cell + 1, word_size)
+    );
+  }
+}
+
+models::stepper::stepper(
+  types::long_whole_num num_cells,
+  types::short_whole_num l_radius,
+  types::short_whole_num r_radius,
+  types::boundary boundary,
+  const types::rules &rules,
+  models::stepper_kernel kernel
+)
+{
+  if (num_cells == 0 || num_cells > models::stepper::max_size)
+  {
+    throw std::invalid_argument{"Unsupported cellular automata size"};
+  }
+
+  if (l_radius > models::binary_1d_ca::max_l_radius || r_radius > models::binary_1d_ca::max_r_radius)
+  {
+    throw std::invalid_argument{"Unsupported radius"};
+  }
+
+  types::short_whole_num num_neighbors{static_cast<types::short_whole_num>(l_radius + r_radius + 1)};
+
+  if (num_neighbors > models::binary_1d_ca::max_num_neighbors)
+  {
+    throw std::invalid_argument{"Unsupported neighborhood size"};
+  }
+
+  if (num_neighbors > num_cells)
+  {
+    throw std::invalid_argument{"Neighborhood size can't be greater than CA size"};
+  }
+
+  if (rules.empty() || num_cells % rules.size() != 0)
+  {
+    throw std::invalid_argument{"The rules must repeat a whole number of times along the lattice"};
+  }
+
+  for (const auto &rule : rules)
+  {
+    if (num_neighbors < 6 && rule >= (1UL << (1U << num_neighbors)))
+    {
+      throw std::invalid_argument{"Invalid rule: " + std::to_string(rule)};
+    }
+  }
+
+  this->num_cells = num_cells;
+  this->l_radius = l_radius;
+  this->r_radius = r_radius;
+  this->boundary = boundary;
+  this->rules = rules;
+  this->kernel = kernel;
+
+  switch (kernel)
+  {
+    case models::stepper_kernel::scalar:
+      break;
+
+    case models::stepper_kernel::bitsliced:
+      this->fill_rule_masks();
+      break;
+
+    case models::stepper_kernel::lookup_8:
+      this->window_size = 8;
+      this->fill_tables();
+      break;
+
+    case models::stepper_kernel::lookup_16:
+      this->window_size = 16;
+      this->fill_tables();
+      break;
+
+    case models::stepper_kernel::compiled:
+      this->fill_programs();
+      break;
+  }
+}
+
+// Cell i is character i of the string, and bit (i % 64) of word (i / 64).
+std::vector<types::long_whole_num>
+models::stepper::pack(const std::string &config_str)
+{
+  std::vector<types::long_whole_num> config((config_str.size() + word_size - 1) / word_size);
+
+  for (types::long_whole_num i{}; i < config_str.size(); i++)
+  {
+    if (config_str[i] != '0' && config_str[i] != '1')
+    {
+      throw std::invalid_argument{"Configurations can only have 0s and 1s"};
+    }
+
+    config[i / word_size] |= static_cast<types::long_whole_num>(config_str[i] == '1') << (i % word_size);
+  }
+
+  return config;
+}
+
+std::string
+models::stepper::unpack(const std::vector<types::long_whole_num> &config, types::long_whole_num num_cells)
+{
+  std::string config_str(num_cells, '0');
+
+  for (types::long_whole_num i{}; i < num_cells; i++)
+  {
+    config_str[i] = ((config[i / word_size] >> (i % word_size)) & 1) ? '1' : '0';
+  }
+
+  return config_str;
+}
+
+types::long_whole_num
+models::stepper::get_num_cells() const
+{
+  return this->num_cells;
+}
+
+types::long_whole_num
+models::stepper::get_num_words() const
+{
+  return (this->num_cells + word_size - 1) / word_size;
+}
+
+types::long_whole_num
+models::stepper::get_num_tables() const
+{
+  return this->tables.size();
+}
+
+void
+models::stepper::step(const std::vector<types::long_whole_num> &config, std::vector<types::long_whole_num> &next_config) const
+{
+  types::long_whole_num num_words{this->get_num_words()};
+
+  if (config.size() < num_words)
+  {
+    throw std::invalid_argument{"The configuration has fewer cells than the stepper"};
+  }
+
+  next_config.assign(num_words, 0);
+
+  switch (this->kernel)
+  {
+    case models::stepper_kernel::scalar:
+      this->step_scalar(config, next_config);
+      break;
+
+    case models::stepper_kernel::bitsliced:
+      this->step_bitsliced(config, next_config);
+      break;
+
+    case models::stepper_kernel::lookup_8:
+    case models::stepper_kernel::lookup_16:
+      this->step_lookup(config, next_config);
+      break;
+
+    case models::stepper_kernel::compiled:
+      this->step_compiled(config, next_config);
+      break;
+  }
+
+  next_config[num_words - 1] &= get_low_mask(static_cast<types::short_whole_num>(this->num_cells - (num_words - 1) * word_size));
+}
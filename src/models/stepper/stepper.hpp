@@ -0,0 +1,134 @@
+#ifndef __STEPPER__
+#define __STEPPER__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../types/types.hpp"
+#include "../rule-program/rule-program.hpp"
+
+namespace models
+{
+  enum stepper_kernel
+  {
+    scalar,
+    bitsliced,
+    lookup_8,
+    lookup_16,
+    compiled
+  };
+
+  // Steps 1D CAs with hybrid rules on packed lattices, 64 cells to a word, with cell i at bit (i % 64) of word (i / 64).
+  //
+  // The kernels trade set-up for throughput.
+  //   - Scalar looks up the rule of every cell separately, and is the reference for the others.
+  //   - Bitsliced evaluates 64 cells at once, as the OR of the neighborhoods on which each cell's rule is 1.
+  //     The rules are sliced into one mask per neighborhood, so hybrid rules cost the same as uniform ones.
+  //   - Lookup maps the (w + l + r) input cells of a window of w = 8 or 16 output cells straight to its outputs.
+  //     Windows with the same rules share a table, and the tables are cached across steppers.
+  //     A table has 2^(w + l + r) entries, so 16-cell windows only pay off for uniform or periodic rules.
+  //     The tables of a stepper, and the tables kept in the cache, take at most `max_table_bytes` each.
+  //   - Compiled runs the Boolean formula of every rule over the neighbor words, masked to the cells that follow the rule.
+  //     Uniform ECAs with a hand written `eca_formula` run it inlined, and other rules run their `rule_program`.
+  //
+  // The rules repeat along the lattice, so a single rule is a uniform CA.
+  // A stepper reuses its own scratch buffer, so it must not be shared across threads.
+  class stepper
+  {
+    private:
+      types::long_whole_num num_cells{};
+      types::short_whole_num l_radius{};
+      types::short_whole_num r_radius{};
+      types::boundary boundary{};
+      types::rules rules{};
+      models::stepper_kernel kernel{};
+
+      // The cells being stepped, with a word of boundary cells on either side.
+      mutable std::vector<types::long_whole_num> padded_words{};
+
+      // Bit i of mask p is set when the rule of cell i is 1 on neighborhood p.
+      std::vector<std::vector<types::long_whole_num>> rule_masks{};
+
+      types::short_whole_num window_size{};
+      std::vector<std::shared_ptr<const std::vector<types::short_whole_num>>> tables{};
+
+      // For every word, the programs of the rules in it, and the cells that follow each of them.
+      std::vector<models::rule_program> programs{};
+      std::vector<std::vector<std::pair<types::short_whole_num, types::long_whole_num>>> word_programs{};
+      mutable std::vector<types::long_whole_num> registers{};
+
+      void (models::stepper::*formula_step)(
+        const std::vector<types::long_whole_num> &config,
+        std::vector<types::long_whole_num> &next_config
+      ) const{};
+
+      bool
+      get_cell(const std::vector<types::long_whole_num> &config, types::long_num cell_num) const;
+
+      void
+      fill_padded_words(const std::vector<types::long_whole_num> &config) const;
+
+      types::long_whole_num
+      get_padded_bits(types::long_num start, types::short_whole_num count) const;
+
+      void
+      fill_rule_masks();
+
+      void
+      fill_tables();
+
+      void
+      fill_programs();
+
+      void
+      step_scalar(const std::vector<types::long_whole_num> &config, std::vector<types::long_whole_num> &next_config) const;
+
+      void
+      step_bitsliced(const std::vector<types::long_whole_num> &config, std::vector<types::long_whole_num> &next_config) const;
+
+      void
+      step_lookup(const std::vector<types::long_whole_num> &config, std::vector<types::long_whole_num> &next_config) const;
+
+      void
+      step_compiled(const std::vector<types::long_whole_num> &config, std::vector<types::long_whole_num> &next_config) const;
+
+      template <types::long_whole_num rule>
+      void
+      step_formula(const std::vector<types::long_whole_num> &config, std::vector<types::long_whole_num> &next_config) const;
+
+    public:
+      static const types::long_whole_num max_size{1UL << 30};
+      static const types::long_whole_num max_table_bytes{1UL << 26};
+
+      stepper(
+        types::long_whole_num num_cells,
+        types::short_whole_num l_radius,
+        types::short_whole_num r_radius,
+        types::boundary boundary,
+        const types::rules &rules,
+        models::stepper_kernel kernel
+      );
+
+      static std::vector<types::long_whole_num>
+      pack(const std::string &config_str);
+
+      static std::string
+      unpack(const std::vector<types::long_whole_num> &config, types::long_whole_num num_cells);
+
+      types::long_whole_num
+      get_num_cells() const;
+
+      types::long_whole_num
+      get_num_words() const;
+
+      types::long_whole_num
+      get_num_tables() const;
+
+      // The configurations must not alias.
+      void
+      step(const std::vector<types::long_whole_num> &config, std::vector<types::long_whole_num> &next_config) const;
+  };
+}
+
+#endif
@@ -0,0 +1,204 @@
+#include "../output.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+struct pending_record
+{
+  types::long_whole_num key{};
+  types::long_whole_num sequence{};
+  output::row entries{};
+};
+
+// `std::push_heap` builds a max-heap, so the comparison is reversed to keep the smallest key on top.
+static bool
+by_key_desc(const pending_record &obj_1, const pending_record &obj_2)
+{
+  if (obj_1.key != obj_2.key)
+  {
+    return obj_1.key > obj_2.key;
+  }
+
+  return obj_1.sequence > obj_2.sequence;
+}
+
+// After an error, rows are still drained so that producers never wait on a full queue, but they are dropped.
+void
+output::async_writer::write(output::row &entries)
+{
+  if (this->error)
+  {
+    return;
+  }
+
+  try
+  {
+    this->emit(entries);
+  }
+  catch (...)
+  {
+    this->error = std::current_exception();
+  }
+}
+
+void
+output::async_writer::run()
+{
+  std::vector<pending_record> pending_records{};
+  types::long_whole_num sequence{};
+
+  while (true)
+  {
+    bool is_closing{this->is_closing.load(std::memory_order_acquire)};
+    bool did_work{};
+    types::long_whole_num bound{std::numeric_limits<types::long_whole_num>::max()};
+
+    // The bound must be read before the queues are drained.
+    // Any row with a smaller key was pushed before its producer advanced, and so is visible while draining.
+    if (this->is_ordered)
+    {
+      for (const auto &current_queue : this->queues)
+      {
+        if (!current_queue->is_finished.load(std::memory_order_acquire))
+        {
+          bound = std::min(bound, current_queue->watermark.load(std::memory_order_acquire));
+        }
+      }
+    }
+
+    for (const auto &current_queue : this->queues)
+    {
+      types::long_whole_num head{current_queue->head.load(std::memory_order_relaxed)};
+      types::long_whole_num tail{current_queue->tail.load(std::memory_order_acquire)};
+
+      while (head < tail)
+      {
+        record &current_record{current_queue->slots.at(head % current_queue->slots.size())};
+
+        if (this->is_ordered)
+        {
+          pending_records.push_back({current_record.key, sequence++, std::move(current_record.entries)});
+          std::push_heap(pending_records.begin(), pending_records.end(), by_key_desc);
+        }
+        else
+        {
+          this->write(current_record.entries);
+        }
+
+        head += 1;
+        did_work = true;
+      }
+
+      current_queue->head.store(head, std::memory_order_release);
+    }
+
+    while (!pending_records.empty() && (is_closing || pending_records.front().key < bound))
+    {
+      std::pop_heap(pending_records.begin(), pending_records.end(), by_key_desc);
+      this->write(pending_records.back().entries);
+      pending_records.pop_back();
+      did_work = true;
+    }
+
+    if (is_closing)
+    {
+      break;
+    }
+
+    if (!did_work)
+    {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+
+  try
+  {
+    output::flush();
+  }
+  catch (...)
+  {
+    this->error = this->error ? this->error : std::current_exception();
+  }
+}
+
+void
+output::async_writer::join()
+{
+  if (this->writer_thread.joinable())
+  {
+    this->is_closing.store(true, std::memory_order_release);
+    this->writer_thread.join();
+  }
+}
+
+output::async_writer::async_writer(
+  types::whole_num num_producers,
+  bool is_ordered,
+  const std::function<void(output::row &)> &emit,
+  types::whole_num capacity
+)
+{
+  this->is_ordered = is_ordered;
+  this->emit = emit;
+
+  for (types::whole_num i{}; i < num_producers; i++)
+  {
+    this->queues.push_back(std::make_unique<queue>());
+    this->queues.back()->slots.resize(std::max(capacity, 1U));
+  }
+
+  this->writer_thread = std::thread{&output::async_writer::run, this};
+}
+
+// Errors can't be thrown from a destructor, so they are only reported by an explicit `close`.
+output::async_writer::~async_writer()
+{
+  this->join();
+}
+
+void
+output::async_writer::push(types::whole_num producer, types::long_whole_num key, output::row &&entries)
+{
+  queue &current_queue{*this->queues.at(producer)};
+  types::long_whole_num tail{current_queue.tail.load(std::memory_order_relaxed)};
+
+  while (tail - current_queue.head.load(std::memory_order_acquire) >= current_queue.slots.size())
+  {
+    std::this_thread::yield();
+  }
+
+  record &current_record{current_queue.slots.at(tail % current_queue.slots.size())};
+  current_record.key = key;
+  current_record.entries = std::move(entries);
+
+  current_queue.tail.store(tail + 1, std::memory_order_release);
+  current_queue.watermark.store(key, std::memory_order_release);
+}
+
+void
+output::async_writer::advance(types::whole_num producer, types::long_whole_num key)
+{
+  this->queues.at(producer)->watermark.store(key, std::memory_order_release);
+}
+
+void
+output::async_writer::finish(types::whole_num producer)
+{
+  this->queues.at(producer)->is_finished.store(true, std::memory_order_release);
+}
+
+// All the producers must have stopped pushing before closing.
+// The remaining rows are written out, and the call returns once the writer thread exits.
+void
+output::async_writer::close()
+{
+  this->join();
+
+  if (this->error)
+  {
+    std::exception_ptr current_error{this->error};
+    this->error = nullptr;
+    std::rethrow_exception(current_error);
+  }
+}
@@ -0,0 +1,108 @@
+#include "../output.hpp"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+static std::unique_ptr<output::sink> current_sink{};
+
+static std::unique_ptr<output::sink>
+make_sink(output::format format, std::FILE *file, bool owns_file)
+{
+  switch (format)
+  {
+    case output::format::csv:
+      return std::make_unique<output::csv_sink>(file, owns_file);
+
+    case output::format::jsonl:
+      return std::make_unique<output::jsonl_sink>(file, owns_file);
+
+    case output::format::binary:
+      return std::make_unique<output::binary_sink>(file, owns_file);
+
+    default:
+      return std::make_unique<output::table_sink>(file, owns_file);
+  }
+}
+
+output::format
+output::parse_format(const std::string &str)
+{
+  if (str == "table")
+  {
+    return output::format::table;
+  }
+
+  if (str == "csv")
+  {
+    return output::format::csv;
+  }
+
+  if (str == "jsonl")
+  {
+    return output::format::jsonl;
+  }
+
+  if (str == "binary")
+  {
+    return output::format::binary;
+  }
+
+  throw std::invalid_argument{"Unsupported output format - " + str};
+}
+
+output::sink &
+output::get_sink()
+{
+  if (!current_sink)
+  {
+    current_sink = make_sink(output::format::table, stdout, false);
+  }
+
+  return *current_sink;
+}
+
+// An empty path selects stdout.
+void
+output::set_sink(output::format format, const std::string &path)
+{
+  std::FILE *file{stdout};
+
+  if (!path.empty())
+  {
+    file = std::fopen(path.c_str(), format == output::format::binary ? "wb" : "w");
+
+    if (file == nullptr)
+    {
+      throw std::runtime_error{"Cannot open " + path + " - " + std::strerror(errno)};
+    }
+  }
+
+  current_sink.reset();
+  current_sink = make_sink(format, file, file != stdout);
+}
+
+// Terminals stay line buffered, so that interactive output appears immediately.
+void
+output::initialize()
+{
+  if (!output::is_terminal(stdout))
+  {
+    std::setvbuf(stdout, nullptr, _IOFBF, 1U << 20);
+  }
+}
+
+bool
+output::is_terminal(std::FILE *file)
+{
+  return isatty(fileno(file)) == 1;
+}
+
+void
+output::flush()
+{
+  output::get_sink().flush();
+}
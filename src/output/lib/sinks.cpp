@@ -0,0 +1,391 @@
+#include "../output.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include "../../terminal/terminal.hpp"
+
+static void
+append_json_string(std::string &out, const std::string &str)
+{
+  static const char hex_digits[]{"0123456789abcdef"};
+  out += '"';
+
+  for (const auto &current_char : str)
+  {
+    switch (current_char)
+    {
+      case '"':
+        out += "\\\"";
+        break;
+
+      case '\\':
+        out += "\\\\";
+        break;
+
+      case '\n':
+        out += "\\n";
+        break;
+
+      case '\t':
+        out += "\\t";
+        break;
+
+      default:
+        if (static_cast<unsigned char>(current_char) < 0x20)
+        {
+          out += "\\u00";
+          out += hex_digits[(current_char >> 4) & 0xF];
+          out += hex_digits[current_char & 0xF];
+        }
+        else
+        {
+          out += current_char;
+        }
+    }
+  }
+
+  out += '"';
+}
+
+static void
+append_json_value(std::string &out, const std::string &str, output::field_type column_type)
+{
+  switch (column_type)
+  {
+    case output::field_type::number:
+      out += str;
+      break;
+
+    case output::field_type::boolean:
+      out += str == "True" ? "true" : "false";
+      break;
+
+    // Rule vectors are printed as "[ 90 150 90 ]".
+    case output::field_type::number_list:
+    {
+      std::istringstream in_stream{str.substr(1, str.size() - 2)};
+      std::string current_num{};
+      bool is_first{true};
+      out += '[';
+
+      while (in_stream >> current_num)
+      {
+        out += is_first ? "" : ",";
+        out += current_num;
+        is_first = false;
+      }
+
+      out += ']';
+      break;
+    }
+
+    default:
+      append_json_string(out, str);
+  }
+}
+
+static void
+append_csv_field(std::string &out, const std::string &str)
+{
+  if (str.find_first_of(",\"\n\r") == std::string::npos)
+  {
+    out += str;
+    return;
+  }
+
+  out += '"';
+
+  for (const auto &current_char : str)
+  {
+    out += current_char;
+    out += current_char == '"' ? "\"" : "";
+  }
+
+  out += '"';
+}
+
+void
+output::sink::fail()
+{
+  this->has_failed = true;
+  throw std::runtime_error{std::string{"Cannot write output - "} + std::strerror(errno)};
+}
+
+void
+output::sink::write_record()
+{
+  bool is_written{this->has_failed || std::fwrite(this->record.data(), 1, this->record.size(), this->file) == this->record.size()};
+  this->record.clear();
+
+  if (!is_written)
+  {
+    this->fail();
+  }
+}
+
+output::sink::sink(std::FILE *file, bool owns_file)
+{
+  this->file = file;
+  this->owns_file = owns_file;
+  this->use_color = output::is_terminal(file);
+
+  // Buffering can only be changed before the first write, so it is set only on files opened for this sink.
+  if (this->owns_file)
+  {
+    std::setvbuf(this->file, nullptr, _IOFBF, 1U << 20);
+  }
+}
+
+output::sink::~sink()
+{
+  if (this->owns_file)
+  {
+    std::fclose(this->file);
+  }
+  else
+  {
+    std::fflush(this->file);
+  }
+}
+
+bool
+output::sink::has_color() const
+{
+  return this->use_color;
+}
+
+void
+output::sink::flush()
+{
+  if (!this->has_failed && (std::fflush(this->file) != 0 || std::ferror(this->file)))
+  {
+    this->fail();
+  }
+}
+
+void
+output::sink::write_msg(const std::string &msg, const std::string &color, bool new_line)
+{
+  bool with_color{this->use_color && !color.empty()};
+
+  this->record += with_color ? color : "";
+  this->record += new_line ? "\n" : "";
+  this->record += msg;
+  this->record += '\n';
+  this->record += with_color ? colors::reset : "";
+  this->write_record();
+}
+
+// The border depends only on the column widths, so it is rebuilt only when they change.
+void
+output::table_sink::append_border(const output::row &entries)
+{
+  bool is_same{this->border_widths.size() == entries.size()};
+
+  for (types::whole_num i{}; is_same && i < entries.size(); i++)
+  {
+    is_same = this->border_widths.at(i) == entries.at(i).second;
+  }
+
+  if (!is_same)
+  {
+    this->border.clear();
+    this->border_widths.clear();
+
+    for (const auto &entry : entries)
+    {
+      this->border += "+-";
+      this->border.append(entry.second, '-');
+      this->border += '-';
+      this->border_widths.push_back(entry.second);
+    }
+
+    this->border += '+';
+  }
+
+  this->record += this->border;
+}
+
+void
+output::table_sink::append_content(const output::row &entries)
+{
+  for (const auto &entry : entries)
+  {
+    this->record += "| ";
+
+    if (entry.first.size() < entry.second)
+    {
+      this->record.append(entry.second - entry.first.size(), ' ');
+    }
+
+    this->record += entry.first;
+    this->record += ' ';
+  }
+
+  this->record += '|';
+}
+
+void
+output::table_sink::write_header(const output::row &headings, const output::field_types &, const std::string &color)
+{
+  this->record += this->use_color ? color : "";
+  this->record += '\n';
+  this->append_border(headings);
+  this->record += '\n';
+  this->append_content(headings);
+  this->record += '\n';
+  this->append_border(headings);
+  this->record += '\n';
+  this->record += this->use_color ? colors::reset : "";
+  this->write_record();
+}
+
+void
+output::table_sink::write_row(const output::row &entries, const std::string &color)
+{
+  this->record += this->use_color ? color : "";
+  this->append_content(entries);
+  this->record += '\n';
+  this->append_border(entries);
+  this->record += '\n';
+  this->record += this->use_color ? colors::reset : "";
+  this->write_record();
+}
+
+output::machine_sink::machine_sink(std::FILE *file, bool owns_file) : sink(file, owns_file)
+{
+  this->use_color = false;
+}
+
+void
+output::machine_sink::write_msg(const std::string &msg, const std::string &, bool)
+{
+  if (!this->is_message_table)
+  {
+    this->write_header({std::make_pair<std::string, types::short_whole_num>("Message", 0)}, {output::field_type::text}, "");
+    this->is_message_table = true;
+  }
+
+  this->write_row({std::make_pair<std::string, types::short_whole_num>(std::string{msg}, 0)}, "");
+}
+
+void
+output::csv_sink::write_header(const output::row &headings, const output::field_types &, const std::string &)
+{
+  this->is_message_table = false;
+
+  for (types::whole_num i{}; i < headings.size(); i++)
+  {
+    this->record += i == 0 ? "" : ",";
+    append_csv_field(this->record, headings.at(i).first);
+  }
+
+  this->record += '\n';
+  this->write_record();
+}
+
+void
+output::csv_sink::write_row(const output::row &entries, const std::string &)
+{
+  for (types::whole_num i{}; i < entries.size(); i++)
+  {
+    this->record += i == 0 ? "" : ",";
+    append_csv_field(this->record, entries.at(i).first);
+  }
+
+  this->record += '\n';
+  this->write_record();
+}
+
+void
+output::jsonl_sink::write_header(const output::row &headings, const output::field_types &column_types, const std::string &)
+{
+  this->is_message_table = false;
+  this->column_names.clear();
+  this->column_types = column_types;
+
+  for (const auto &heading : headings)
+  {
+    this->column_names.push_back(heading.first);
+  }
+}
+
+void
+output::jsonl_sink::write_row(const output::row &entries, const std::string &)
+{
+  this->record += '{';
+
+  for (types::whole_num i{}; i < entries.size(); i++)
+  {
+    this->record += i == 0 ? "" : ",";
+
+    if (i < this->column_names.size())
+    {
+      append_json_string(this->record, this->column_names.at(i));
+    }
+    else
+    {
+      append_json_string(this->record, "column_" + std::to_string(i + 1));
+    }
+
+    this->record += ':';
+    append_json_value(
+      this->record,
+      entries.at(i).first,
+      i < this->column_types.size() ? this->column_types.at(i) : output::field_type::text
+    );
+  }
+
+  this->record += "}\n";
+  this->write_record();
+}
+
+void
+output::binary_sink::append_varint(types::long_whole_num value)
+{
+  while (value >= 0x80)
+  {
+    this->record += static_cast<char>((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+
+  this->record += static_cast<char>(value);
+}
+
+void
+output::binary_sink::append_record(char tag, const output::row &entries)
+{
+  if (!this->magic_written)
+  {
+    this->record += "CAR1";
+    this->magic_written = true;
+  }
+
+  this->record += tag;
+  this->append_varint(entries.size());
+
+  for (const auto &entry : entries)
+  {
+    this->append_varint(entry.first.size());
+    this->record += entry.first;
+  }
+
+  this->write_record();
+}
+
+void
+output::binary_sink::write_header(const output::row &headings, const output::field_types &, const std::string &)
+{
+  this->is_message_table = false;
+  this->append_record('H', headings);
+}
+
+void
+output::binary_sink::write_row(const output::row &entries, const std::string &)
+{
+  this->append_record('R', entries);
+}
@@ -0,0 +1,270 @@
+#ifndef __OUTPUT__
+#define __OUTPUT__
+
+#include <atomic>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../types/types.hpp"
+
+namespace output
+{
+  enum format
+  {
+    table,
+    csv,
+    jsonl,
+    binary
+  };
+
+  // Each entry is a (value, column width) pair, as passed to `utils::general::print_row`.
+  // Column widths are only used by the table format.
+  using row = std::vector<std::pair<std::string, types::short_whole_num>>;
+
+  // The type of the values in a column, declared along with its heading.
+  // Rule vectors are number lists, and configurations are text, even though they are made of digits.
+  enum field_type
+  {
+    text,
+    number,
+    number_list,
+    boolean
+  };
+
+  using field_types = std::vector<output::field_type>;
+
+  // A sink receives every tabular result, and writes it out in a particular format.
+  // Records are assembled in a reusable string, and handed to a large stdio buffer with a single write.
+  // The first write error is thrown as `std::runtime_error`, and later writes to the broken stream are dropped.
+  class sink
+  {
+    protected:
+      std::FILE *file{};
+      bool owns_file{};
+      bool use_color{};
+      bool has_failed{};
+      std::string record{};
+
+      void
+      fail();
+
+      void
+      write_record();
+
+    public:
+      sink(std::FILE *file, bool owns_file);
+
+      sink(const sink &other) = delete;
+
+      sink &
+      operator=(const sink &other) = delete;
+
+      virtual ~sink();
+
+      bool
+      has_color() const;
+
+      void
+      flush();
+
+      virtual void
+      write_header(const output::row &headings, const output::field_types &column_types, const std::string &color) = 0;
+
+      virtual void
+      write_row(const output::row &entries, const std::string &color) = 0;
+
+      virtual void
+      write_msg(const std::string &msg, const std::string &color, bool new_line);
+  };
+
+  // ASCII tables, as printed by the interactive menu.
+  class table_sink : public sink
+  {
+    private:
+      std::vector<types::short_whole_num> border_widths{};
+      std::string border{};
+
+      void
+      append_border(const output::row &entries);
+
+      void
+      append_content(const output::row &entries);
+
+    public:
+      using sink::sink;
+
+      void
+      write_header(const output::row &headings, const output::field_types &column_types, const std::string &color) override;
+
+      void
+      write_row(const output::row &entries, const std::string &color) override;
+  };
+
+  // Machine readable sinks write messages as records of a table with a single "Message" column.
+  // Consecutive messages share one header, and colors are never written.
+  class machine_sink : public sink
+  {
+    protected:
+      bool is_message_table{};
+
+    public:
+      machine_sink(std::FILE *file, bool owns_file);
+
+      void
+      write_msg(const std::string &msg, const std::string &color, bool new_line) override;
+  };
+
+  // One line per record, with a header line for each table.
+  // Fields are quoted as per RFC 4180, only when needed.
+  class csv_sink : public machine_sink
+  {
+    public:
+      using machine_sink::machine_sink;
+
+      void
+      write_header(const output::row &headings, const output::field_types &column_types, const std::string &color) override;
+
+      void
+      write_row(const output::row &entries, const std::string &color) override;
+  };
+
+  // One JSON object per record, keyed by the column names of the latest header.
+  // Values are emitted as JSON strings, numbers, arrays of numbers or booleans, as per the declared column types.
+  class jsonl_sink : public machine_sink
+  {
+    private:
+      std::vector<std::string> column_names{};
+      output::field_types column_types{};
+
+    public:
+      using machine_sink::machine_sink;
+
+      void
+      write_header(const output::row &headings, const output::field_types &column_types, const std::string &color) override;
+
+      void
+      write_row(const output::row &entries, const std::string &color) override;
+  };
+
+  // The stream starts with the 4 byte magic "CAR1".
+  // It is followed by records, each made of a tag byte ('H' for a header, 'R' for a row), the number of fields and the fields.
+  // Every field is its length followed by its bytes.
+  // Counts and lengths are unsigned LEB128 varints.
+  class binary_sink : public machine_sink
+  {
+    private:
+      bool magic_written{};
+
+      void
+      append_varint(types::long_whole_num value);
+
+      void
+      append_record(char tag, const output::row &entries);
+
+    public:
+      using machine_sink::machine_sink;
+
+      void
+      write_header(const output::row &headings, const output::field_types &column_types, const std::string &color) override;
+
+      void
+      write_row(const output::row &entries, const std::string &color) override;
+  };
+
+  // Compute threads push rows into their own single-producer queue, and a dedicated thread writes them out.
+  // Pushing never takes a lock. When a queue is full, its producer waits for the writer to catch up.
+  //
+  // Every row carries a key, and every producer must push its rows in non-decreasing key order.
+  // In ordered mode, rows are written in increasing key order across all producers.
+  // A row is written once every unfinished producer has advanced past its key.
+  //
+  // An error thrown while writing stops the output, and is rethrown by `close`.
+  class async_writer
+  {
+    private:
+      struct record
+      {
+        types::long_whole_num key{};
+        output::row entries{};
+      };
+
+      struct queue
+      {
+        std::vector<record> slots{};
+        alignas(64) std::atomic<types::long_whole_num> head{};
+        alignas(64) std::atomic<types::long_whole_num> tail{};
+        alignas(64) std::atomic<types::long_whole_num> watermark{};
+        std::atomic<bool> is_finished{};
+      };
+
+      bool is_ordered{};
+      std::atomic<bool> is_closing{};
+      std::vector<std::unique_ptr<queue>> queues{};
+      std::function<void(output::row &)> emit{};
+      std::exception_ptr error{};
+      std::thread writer_thread{};
+
+      void
+      write(output::row &entries);
+
+      void
+      run();
+
+      void
+      join();
+
+    public:
+      async_writer(
+        types::whole_num num_producers,
+        bool is_ordered,
+        const std::function<void(output::row &)> &emit,
+        types::whole_num capacity = 4096
+      );
+
+      async_writer(const async_writer &other) = delete;
+
+      async_writer &
+      operator=(const async_writer &other) = delete;
+
+      ~async_writer();
+
+      void
+      push(types::whole_num producer, types::long_whole_num key, output::row &&entries);
+
+      void
+      advance(types::whole_num producer, types::long_whole_num key);
+
+      void
+      finish(types::whole_num producer);
+
+      void
+      close();
+  };
+
+  output::format
+  parse_format(const std::string &str);
+
+  output::sink &
+  get_sink();
+
+  void
+  set_sink(output::format format, const std::string &path = "");
+
+  // Must be called before anything is written to stdout.
+  void
+  initialize();
+
+  bool
+  is_terminal(std::FILE *file);
+
+  void
+  flush();
+}
+
+#endif
@@ -0,0 +1,78 @@
+#include "../utils.hpp"
+
+#include <algorithm>
+
+// Reflecting the neighborhood of a uniform ECA gives the rule that evolves the mirror image of every configuration.
+// So the CA of the reflected rule is the original one with the cells reversed, under either boundary.
+types::long_whole_num
+utils::eca_symmetry::get_reflected_rule(types::long_whole_num rule)
+{
+  types::long_whole_num reflected_rule{};
+
+  for (types::short_whole_num i{}; i < 8; i++)
+  {
+    types::short_whole_num reflected_neighborhood{static_cast<types::short_whole_num>(
+      ((i & 1) << 2) | (i & 2) | ((i >> 2) & 1)
+    )};
+
+    reflected_rule |= ((rule >> i) & 1) << reflected_neighborhood;
+  }
+
+  return reflected_rule;
+}
+
+// The conjugated rule evolves the complement of every configuration, i.e. f'(x) = ~f(~x).
+// Under a null boundary the cells beyond the ends stay 0 and are not complemented, so this holds only for periodic boundaries.
+types::long_whole_num
+utils::eca_symmetry::get_conjugated_rule(types::long_whole_num rule)
+{
+  types::long_whole_num conjugated_rule{};
+
+  for (types::short_whole_num i{}; i < 8; i++)
+  {
+    conjugated_rule |= (((rule >> (7 - i)) & 1) ^ 1) << i;
+  }
+
+  return conjugated_rule;
+}
+
+// The rules whose CAs have transition graphs isomorphic to that of the given rule, through reflection and conjugation.
+std::vector<types::long_whole_num>
+utils::eca_symmetry::get_orbit(types::long_whole_num rule, types::boundary boundary)
+{
+  std::vector<types::long_whole_num> orbit{rule, utils::eca_symmetry::get_reflected_rule(rule)};
+
+  if (boundary == types::boundary::periodic)
+  {
+    orbit.push_back(utils::eca_symmetry::get_conjugated_rule(rule));
+    orbit.push_back(utils::eca_symmetry::get_conjugated_rule(utils::eca_symmetry::get_reflected_rule(rule)));
+  }
+
+  std::sort(orbit.begin(), orbit.end());
+  orbit.erase(std::unique(orbit.begin(), orbit.end()), orbit.end());
+
+  return orbit;
+}
+
+types::long_whole_num
+utils::eca_symmetry::get_representative(types::long_whole_num rule, types::boundary boundary)
+{
+  return utils::eca_symmetry::get_orbit(rule, boundary).front();
+}
+
+// There are 88 classes under periodic boundaries, and 160 under null boundaries.
+std::vector<types::long_whole_num>
+utils::eca_symmetry::get_representatives(types::boundary boundary)
+{
+  std::vector<types::long_whole_num> representatives{};
+
+  for (types::long_whole_num rule{}; rule < 256; rule++)
+  {
+    if (utils::eca_symmetry::get_representative(rule, boundary) == rule)
+    {
+      representatives.push_back(rule);
+    }
+  }
+
+  return representatives;
+}
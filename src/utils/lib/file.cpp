@@ -0,0 +1,87 @@
+#include "../utils.hpp"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+// Missing parent directories are created too, with the same mode.
+void
+utils::file::make_directory(const std::string &path, unsigned int mode)
+{
+  std::size_t separator{path.find('/', 1)};
+
+  while (true)
+  {
+    std::string current_path{path.substr(0, separator)};
+
+    if (mkdir(current_path.c_str(), mode) != 0 && errno != EEXIST)
+    {
+      throw std::runtime_error{"Cannot create directory " + current_path + " - " + std::strerror(errno)};
+    }
+
+    if (separator == std::string::npos)
+    {
+      break;
+    }
+
+    separator = path.find('/', separator + 1);
+  }
+}
+
+bool
+utils::file::read(const std::string &path, std::string &contents)
+{
+  std::FILE *file{std::fopen(path.c_str(), "rb")};
+
+  if (file == nullptr)
+  {
+    return false;
+  }
+
+  char buffer[4096];
+  std::size_t num_bytes{};
+  contents.clear();
+
+  while ((num_bytes = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+  {
+    contents.append(buffer, num_bytes);
+  }
+
+  bool is_read{!std::ferror(file)};
+  std::fclose(file);
+
+  return is_read;
+}
+
+// The contents are written to a temporary file, unique to the process and thread, and then renamed over the path.
+// A rename within a directory is atomic, so concurrent readers see either the old file or the new one, and never a partial write.
+bool
+utils::file::write_atomically(const std::string &path, const std::string &contents)
+{
+  std::ostringstream tmp_path_stream{};
+  tmp_path_stream << path << ".tmp." << getpid() << "." << std::this_thread::get_id();
+  std::string tmp_path{tmp_path_stream.str()};
+
+  std::FILE *file{std::fopen(tmp_path.c_str(), "wb")};
+
+  if (file == nullptr)
+  {
+    return false;
+  }
+
+  bool is_written{std::fwrite(contents.data(), 1, contents.size(), file) == contents.size()};
+  is_written = std::fclose(file) == 0 && is_written;
+
+  if (!is_written || std::rename(tmp_path.c_str(), path.c_str()) != 0)
+  {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+
+  return true;
+}
@@ -1,41 +1,10 @@
 #include "../utils.hpp"
 
 #include <ctime>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
 
-static std::string
-get_border(const std::vector<std::pair<std::string, types::short_whole_num>> &entries)
-{
-  std::ostringstream out_stream{};
-
-  for (const auto &entry : entries)
-  {
-    out_stream << "+-";
-    out_stream << std::string(entry.second, '-');
-    out_stream << "-";
-  }
-
-  out_stream << "+";
-  return out_stream.str();
-}
-
-static std::string
-get_content(const std::vector<std::pair<std::string, types::short_whole_num>> &entries)
-{
-  std::ostringstream out_stream{};
-
-  for (const auto &entry : entries)
-  {
-    out_stream << "| ";
-    out_stream << std::setw(entry.second) << entry.first;
-    out_stream << " ";
-  }
-
-  out_stream << "|";
-  return out_stream.str();
-}
+#include "../../instrument/instrument.hpp"
+#include "../../output/output.hpp"
 
 static types::short_whole_num
 read_choice(types::short_whole_num low, types::short_whole_num high)
@@ -58,19 +27,20 @@ read_choice(types::short_whole_num low, types::short_whole_num high)
 bool
 utils::general::get_random_bool()
 {
-  return rand() % 2 == 0;
+  return (utils::random::next() >> 63) == 0;
 }
 
 types::short_whole_num
 utils::general::get_choice(const std::vector<std::string> &choices)
 {
-  std::cout << decorate::underline;
-  std::cout << colors::pink;
+  bool use_color{output::is_terminal(stdout)};
+
+  output::flush();
+  std::cout << (use_color ? decorate::underline + colors::pink : "");
   std::cout << "\n";
   std::cout << "Menu:";
   std::cout << "\n";
-  std::cout << colors::reset;
-  std::cout << decorate::reset;
+  std::cout << (use_color ? colors::reset + decorate::reset : "");
 
   for (types::short_whole_num i{}; i < choices.size(); i++)
   {
@@ -83,27 +53,19 @@ utils::general::get_choice(const std::vector<std::string> &choices)
 void
 utils::general::initialize()
 {
-  std::srand(std::time(NULL));
+  output::initialize();
+  utils::random::seed(static_cast<types::long_whole_num>(std::time(NULL)));
 }
 
 void
 utils::general::print_header(
   const std::vector<std::pair<std::string, types::short_whole_num>> &headings,
+  const output::field_types &column_types,
   const std::string &color
 )
 {
-  std::string border{get_border(headings)};
-  std::string content{get_content(headings)};
-
-  std::cout << color;
-  std::cout << "\n";
-  std::cout << border;
-  std::cout << "\n";
-  std::cout << content;
-  std::cout << "\n";
-  std::cout << border;
-  std::cout << "\n";
-  std::cout << colors::reset;
+  CA_SCOPED_TIMER(output);
+  output::get_sink().write_header(headings, column_types, color);
 }
 
 void
@@ -112,28 +74,14 @@ utils::general::print_row(
   const std::string &color
 )
 {
-  std::string border{get_border(entries)};
-  std::string content{get_content(entries)};
-
-  std::cout << color;
-  std::cout << content;
-  std::cout << "\n";
-  std::cout << border;
-  std::cout << "\n";
-  std::cout << colors::reset;
+  CA_SCOPED_TIMER(output);
+  CA_COUNT(rows_written, 1);
+  output::get_sink().write_row(entries, color);
 }
 
 void
 utils::general::print_msg(const std::string &msg, const std::string &color, bool new_line)
 {
-  std::cout << color;
-
-  if (new_line)
-  {
-    std::cout << "\n";
-  }
-
-  std::cout << msg;
-  std::cout << '\n';
-  std::cout << colors::reset;
+  CA_SCOPED_TIMER(output);
+  output::get_sink().write_msg(msg, color, new_line);
 }
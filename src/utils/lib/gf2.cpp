@@ -0,0 +1,182 @@
+#include "../utils.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+static const types::short_whole_num max_dimension{64};
+
+std::vector<types::long_whole_num>
+utils::gf2::pack(const types::matrix &A)
+{
+  std::vector<types::long_whole_num> rows{};
+  rows.reserve(A.size());
+
+  for (const auto &row : A)
+  {
+    if (row.size() > max_dimension)
+    {
+      throw std::invalid_argument{"GF(2) matrices can't have more than 64 columns"};
+    }
+
+    types::long_whole_num current_row{};
+
+    for (types::short_whole_num j{}; j < row.size(); j++)
+    {
+      current_row |= static_cast<types::long_whole_num>(utils::math::is_odd(row.at(j))) << j;
+    }
+
+    rows.push_back(current_row);
+  }
+
+  return rows;
+}
+
+std::vector<types::long_whole_num>
+utils::gf2::get_identity(types::short_whole_num size)
+{
+  if (size > max_dimension)
+  {
+    throw std::invalid_argument{"GF(2) matrices can't have more than 64 columns"};
+  }
+
+  std::vector<types::long_whole_num> rows(size);
+
+  for (types::short_whole_num i{}; i < size; i++)
+  {
+    rows.at(i) = 1UL << i;
+  }
+
+  return rows;
+}
+
+// Row i of the product is the XOR of the rows of B selected by the bits of row i of A.
+std::vector<types::long_whole_num>
+utils::gf2::multiply(const std::vector<types::long_whole_num> &A, const std::vector<types::long_whole_num> &B)
+{
+  std::vector<types::long_whole_num> C(A.size());
+
+  for (types::short_whole_num i{}; i < A.size(); i++)
+  {
+    types::long_whole_num remaining_bits{A.at(i)};
+
+    while (remaining_bits)
+    {
+      C.at(i) ^= B.at(__builtin_ctzl(remaining_bits));
+      remaining_bits &= remaining_bits - 1;
+    }
+  }
+
+  return C;
+}
+
+// Square and multiply, so a square matrix is raised to the power t in O(log t) products.
+std::vector<types::long_whole_num>
+utils::gf2::power(const std::vector<types::long_whole_num> &A, types::long_whole_num exponent)
+{
+  std::vector<types::long_whole_num> result{utils::gf2::get_identity(static_cast<types::short_whole_num>(A.size()))};
+  std::vector<types::long_whole_num> current_power{A};
+
+  while (exponent)
+  {
+    if (exponent & 1)
+    {
+      result = utils::gf2::multiply(result, current_power);
+    }
+
+    exponent >>= 1;
+
+    if (exponent)
+    {
+      current_power = utils::gf2::multiply(current_power, current_power);
+    }
+  }
+
+  return result;
+}
+
+// Bit i of the image is the parity of the bits of x selected by row i.
+types::long_whole_num
+utils::gf2::apply(const std::vector<types::long_whole_num> &A, types::long_whole_num x)
+{
+  types::long_whole_num y{};
+
+  for (types::short_whole_num i{}; i < A.size(); i++)
+  {
+    y |= static_cast<types::long_whole_num>(__builtin_parityl(A.at(i) & x)) << i;
+  }
+
+  return y;
+}
+
+// Solves A.x = b by Gauss-Jordan elimination, where bit i of `b` is the right hand side of row i.
+// Each row operation is a single XOR, so the elimination costs O(rows * cols) word operations.
+// Free variables are set to 0, and `x` is left untouched when the system is inconsistent.
+bool
+utils::gf2::solve(
+  std::vector<types::long_whole_num> A,
+  types::short_whole_num num_cols,
+  types::long_whole_num b,
+  types::long_whole_num &x
+)
+{
+  if (A.size() > max_dimension || num_cols > max_dimension)
+  {
+    throw std::invalid_argument{"GF(2) systems can't have more than 64 equations or unknowns"};
+  }
+
+  std::vector<types::short_whole_num> rhs(A.size());
+  std::vector<types::short_whole_num> pivot_cols{};
+
+  for (types::short_whole_num i{}; i < A.size(); i++)
+  {
+    rhs.at(i) = (b >> i) & 1;
+  }
+
+  for (types::short_whole_num j{}; j < num_cols && pivot_cols.size() < A.size(); j++)
+  {
+    types::short_whole_num pivot_row{static_cast<types::short_whole_num>(pivot_cols.size())};
+    types::short_whole_num current_row{pivot_row};
+
+    while (current_row < A.size() && !((A.at(current_row) >> j) & 1))
+    {
+      current_row += 1;
+    }
+
+    if (current_row == A.size())
+    {
+      continue;
+    }
+
+    std::swap(A.at(pivot_row), A.at(current_row));
+    std::swap(rhs.at(pivot_row), rhs.at(current_row));
+
+    for (types::short_whole_num i{}; i < A.size(); i++)
+    {
+      if (i != pivot_row && ((A.at(i) >> j) & 1))
+      {
+        A.at(i) ^= A.at(pivot_row);
+        rhs.at(i) ^= rhs.at(pivot_row);
+      }
+    }
+
+    pivot_cols.push_back(j);
+  }
+
+  // The rows below the pivots are zero, so they are consistent only with a zero right hand side.
+  for (types::short_whole_num i{static_cast<types::short_whole_num>(pivot_cols.size())}; i < A.size(); i++)
+  {
+    if (rhs.at(i))
+    {
+      return false;
+    }
+  }
+
+  x = 0;
+
+  for (types::short_whole_num i{}; i < pivot_cols.size(); i++)
+  {
+    x |= static_cast<types::long_whole_num>(rhs.at(i)) << pivot_cols.at(i);
+  }
+
+  return true;
+}
@@ -16,8 +16,35 @@ utils::number::get_random_num(types::short_whole_num min, types::short_whole_num
     return min;
   }
 
-  types::short_whole_num range{static_cast<types::short_whole_num>(max - min + 1)};
-  return rand() % range + min;
+  // The range is mapped onto the upper 32 bits of a random number by multiplication, instead of a modulo.
+  // Draws that fall into the biased low end of the product are rejected, so every number in the range is equally likely.
+  // Refer, https://arxiv.org/abs/1805.10941.
+  types::long_whole_num range{static_cast<types::long_whole_num>(max - min + 1)};
+  types::long_whole_num threshold{(0x100000000UL - range) % range};
+  types::long_whole_num product{};
+
+  do
+  {
+    product = (utils::random::next() >> 32) * range;
+  } while ((product & 0xFFFFFFFFUL) < threshold);
+
+  return static_cast<types::short_whole_num>((product >> 32) + min);
+}
+
+// This function computes the 64-bit FNV-1a hash of a string.
+// Refer, http://www.isthe.com/chongo/tech/comp/fnv/index.html.
+types::long_whole_num
+utils::number::get_hash(const std::string &str)
+{
+  types::long_whole_num hash{0xCBF29CE484222325UL};
+
+  for (const auto &current_char : str)
+  {
+    hash ^= static_cast<unsigned char>(current_char);
+    hash *= 0x100000001B3UL;
+  }
+
+  return hash;
 }
 
 types::long_whole_num
@@ -32,6 +59,21 @@ utils::number::to_binary_str(types::long_whole_num num, types::short_whole_num n
   return std::bitset<64>{num}.to_string().substr(64 - num_digits);
 }
 
+std::string
+utils::number::to_hex_str(types::long_whole_num num, types::short_whole_num num_digits)
+{
+  static std::string symbols{"0123456789abcdef"};
+  std::string result(num_digits, '0');
+
+  for (types::short_whole_num i{}; i < num_digits; i++)
+  {
+    result.at(num_digits - i - 1) = symbols.at(num & 0xF);
+    num >>= 4;
+  }
+
+  return result;
+}
+
 std::string
 utils::number::to_string(
   types::long_whole_num num,
@@ -0,0 +1,103 @@
+#include "../utils.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+// Random numbers are drawn from xoshiro256** generators, one per thread.
+// Refer, https://prng.di.unimi.it.
+//
+// Every generator is seeded from the pair (global seed, stream id) using splitmix64.
+// So the numbers drawn from a stream depend only on the seed and the stream id, and never on the thread drawing them.
+// Parallel loops that select the stream from the index of the work item are therefore reproducible for any thread count.
+// Threads that never select a stream are assigned one in the order they first draw a number, starting from 0.
+
+struct generator_state
+{
+  std::uint64_t words[4]{};
+  std::uint64_t stream_id{};
+  std::uint64_t generation{};
+  bool is_seeded{};
+};
+
+static std::atomic<std::uint64_t> global_seed{0};
+static std::atomic<std::uint64_t> global_generation{1};
+static std::atomic<std::uint64_t> next_default_stream{0};
+static thread_local generator_state state{};
+
+static std::uint64_t
+splitmix64(std::uint64_t &x)
+{
+  std::uint64_t z{(x += 0x9E3779B97F4A7C15ULL)};
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+static std::uint64_t
+rotl(std::uint64_t x, int k)
+{
+  return (x << k) | (x >> (64 - k));
+}
+
+static void
+reseed_state(std::uint64_t stream_id)
+{
+  std::uint64_t mixer{stream_id};
+  std::uint64_t x{global_seed.load(std::memory_order_relaxed) ^ splitmix64(mixer)};
+
+  for (auto &word : state.words)
+  {
+    word = splitmix64(x);
+  }
+
+  state.stream_id = stream_id;
+  state.generation = global_generation.load(std::memory_order_acquire);
+  state.is_seeded = true;
+}
+
+types::long_whole_num
+utils::random::get_seed()
+{
+  return global_seed.load(std::memory_order_relaxed);
+}
+
+types::long_whole_num
+utils::random::next()
+{
+  if (!state.is_seeded)
+  {
+    reseed_state(next_default_stream.fetch_add(1, std::memory_order_relaxed));
+  }
+  else if (state.generation != global_generation.load(std::memory_order_acquire))
+  {
+    reseed_state(state.stream_id);
+  }
+
+  std::uint64_t *s{state.words};
+  std::uint64_t result{rotl(s[1] * 5, 7) * 9};
+  std::uint64_t t{s[1] << 17};
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 45);
+
+  return result;
+}
+
+// Re-seeding invalidates every thread's generator.
+// Each thread lazily re-derives its state from the new seed, but keeps its stream id.
+void
+utils::random::seed(types::long_whole_num seed)
+{
+  global_seed.store(seed, std::memory_order_relaxed);
+  global_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void
+utils::random::select_stream(types::long_whole_num stream_id)
+{
+  reseed_state(stream_id);
+}
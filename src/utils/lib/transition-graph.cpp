@@ -4,6 +4,9 @@
 #include <sstream>
 #include <unordered_set>
 
+#include "../../instrument/instrument.hpp"
+#include "../../output/output.hpp"
+
 bool
 utils::transition_graph::are_isomorphic(
   const types::transition_graph &G,
@@ -47,6 +50,8 @@ utils::transition_graph::are_isomorphic(
 types::cycles
 utils::transition_graph::get_cycles(const types::transition_graph &graph)
 {
+  CA_SCOPED_TIMER(get_cycles);
+
   types::cycles cycles{};
   types::short_whole_num current_node{};
   std::unordered_set<types::short_whole_num> visited_nodes{};
@@ -102,6 +107,55 @@ utils::transition_graph::get_cycles(const types::transition_graph &graph)
   return cycles;
 }
 
+// The cycle type is the sorted list of the cycle lengths.
+// Two permutations are isomorphic as graphs if and only if their cycle types are equal.
+std::vector<types::short_whole_num>
+utils::transition_graph::get_cycle_type(const types::transition_graph &graph)
+{
+  static const types::short_whole_num unvisited{0};
+  static const types::short_whole_num in_progress{1};
+  static const types::short_whole_num visited{2};
+
+  std::vector<types::short_whole_num> cycle_type{};
+  std::vector<types::short_whole_num> states(graph.size(), unvisited);
+
+  for (types::whole_num i{}; i < graph.size(); i++)
+  {
+    types::short_whole_num current_node{static_cast<types::short_whole_num>(i)};
+
+    while (states[current_node] == unvisited)
+    {
+      states[current_node] = in_progress;
+      current_node = graph[current_node];
+    }
+
+    if (states[current_node] == in_progress)
+    {
+      types::short_whole_num start_node{current_node};
+      types::short_whole_num cycle_length{};
+
+      do
+      {
+        cycle_length += 1;
+        current_node = graph[current_node];
+      } while (current_node != start_node);
+
+      cycle_type.push_back(cycle_length);
+    }
+
+    current_node = static_cast<types::short_whole_num>(i);
+
+    while (states[current_node] == in_progress)
+    {
+      states[current_node] = visited;
+      current_node = graph[current_node];
+    }
+  }
+
+  std::sort(cycle_type.begin(), cycle_type.end());
+  return cycle_type;
+}
+
 void
 utils::transition_graph::print(
   const types::transition_graph &graph,
@@ -109,6 +163,12 @@ utils::transition_graph::print(
   const std::string &regular_color
 )
 {
+  // The colours are embedded within the message, so they are dropped here when the sink can't show them.
+  bool use_color{output::get_sink().has_color()};
+  std::string cycle_code{use_color ? cycle_color : ""};
+  std::string regular_code{use_color ? regular_color : ""};
+  std::string reset_code{use_color ? colors::reset : ""};
+
   std::ostringstream out_stream{};
   bool is_first_cycle{true};
   types::cycles cycles{utils::transition_graph::get_cycles(graph)};
@@ -116,7 +176,7 @@ utils::transition_graph::print(
 
   for (const auto &cycle : cycles)
   {
-    out_stream << cycle_color;
+    out_stream << cycle_code;
     out_stream << (is_first_cycle ? "" : "\n");
 
     types::short_whole_num start_node{*cycle.begin()};
@@ -134,7 +194,7 @@ utils::transition_graph::print(
     }
 
     out_stream << current_node;
-    out_stream << colors::reset;
+    out_stream << reset_code;
     is_first_cycle = false;
   }
 
@@ -154,16 +214,16 @@ utils::transition_graph::print(
 
       if (is_new_component)
       {
-        out_stream << regular_color;
+        out_stream << regular_code;
         out_stream << "\n";
         out_stream << current_node;
-        out_stream << colors::reset;
+        out_stream << reset_code;
       }
 
-      out_stream << regular_color;
+      out_stream << regular_code;
       out_stream << " --> ";
       out_stream << graph.at(current_node);
-      out_stream << colors::reset;
+      out_stream << reset_code;
 
       visited_nodes.insert(current_node);
       current_node = graph.at(current_node);
@@ -6,6 +6,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "../output/output.hpp"
 #include "../terminal/terminal.hpp"
 #include "../types/types.hpp"
 
@@ -23,6 +24,7 @@ namespace utils::general
   void
   print_header(
     const std::vector<std::pair<std::string, types::short_whole_num>> &headings,
+    const output::field_types &column_types,
     const std::string &color = colors::cyan
   );
 
@@ -36,6 +38,63 @@ namespace utils::general
   print_msg(const std::string &msg, const std::string &color = "", bool new_line = true);
 }
 
+namespace utils::eca_symmetry
+{
+  types::long_whole_num
+  get_reflected_rule(types::long_whole_num rule);
+
+  types::long_whole_num
+  get_conjugated_rule(types::long_whole_num rule);
+
+  std::vector<types::long_whole_num>
+  get_orbit(types::long_whole_num rule, types::boundary boundary);
+
+  types::long_whole_num
+  get_representative(types::long_whole_num rule, types::boundary boundary);
+
+  std::vector<types::long_whole_num>
+  get_representatives(types::boundary boundary);
+}
+
+namespace utils::file
+{
+  void
+  make_directory(const std::string &path, unsigned int mode = 0755);
+
+  bool
+  read(const std::string &path, std::string &contents);
+
+  bool
+  write_atomically(const std::string &path, const std::string &contents);
+}
+
+// Matrices over GF(2) are packed row-wise, bit j of row i being the entry at (i, j).
+namespace utils::gf2
+{
+  std::vector<types::long_whole_num>
+  pack(const types::matrix &A);
+
+  std::vector<types::long_whole_num>
+  get_identity(types::short_whole_num size);
+
+  std::vector<types::long_whole_num>
+  multiply(const std::vector<types::long_whole_num> &A, const std::vector<types::long_whole_num> &B);
+
+  std::vector<types::long_whole_num>
+  power(const std::vector<types::long_whole_num> &A, types::long_whole_num exponent);
+
+  types::long_whole_num
+  apply(const std::vector<types::long_whole_num> &A, types::long_whole_num x);
+
+  bool
+  solve(
+    std::vector<types::long_whole_num> A,
+    types::short_whole_num num_cols,
+    types::long_whole_num b,
+    types::long_whole_num &x
+  );
+}
+
 namespace utils::math
 {
   bool
@@ -86,12 +145,18 @@ namespace utils::number
   types::short_whole_num
   get_random_num(types::short_whole_num min, types::short_whole_num max);
 
+  types::long_whole_num
+  get_hash(const std::string &str);
+
   types::long_whole_num
   parse_binary_str(const std::string &str);
 
   std::string
   to_binary_str(types::long_whole_num num, types::short_whole_num num_digits);
 
+  std::string
+  to_hex_str(types::long_whole_num num, types::short_whole_num num_digits);
+
   std::string
   to_string(
     types::long_whole_num num,
@@ -109,6 +174,21 @@ namespace utils::polynomial
   print(const types::polynomial &coeffs, const std::string &color = colors::cyan);
 }
 
+namespace utils::random
+{
+  types::long_whole_num
+  get_seed();
+
+  types::long_whole_num
+  next();
+
+  void
+  seed(types::long_whole_num seed);
+
+  void
+  select_stream(types::long_whole_num stream_id);
+}
+
 namespace utils::sn_map
 {
   bool
@@ -123,6 +203,9 @@ namespace utils::transition_graph
   types::cycles
   get_cycles(const types::transition_graph &graph);
 
+  std::vector<types::short_whole_num>
+  get_cycle_type(const types::transition_graph &graph);
+
   void
   print(
     const types::transition_graph &graph,